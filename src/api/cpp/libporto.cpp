@@ -72,9 +72,14 @@ int Connection::ConnectionImpl::Connect()
     if (Timeout && SetTimeout(3, Timeout))
         return LastError;
 
+    /* PORTO_SOCKET points to portod running with --simulate */
+    const char *path = getenv("PORTO_SOCKET");
+    if (!path)
+        path = PortoSocket;
+
     memset(&peer_addr, 0, sizeof(struct sockaddr_un));
     peer_addr.sun_family = AF_UNIX;
-    strncpy(peer_addr.sun_path, PortoSocket, sizeof(PortoSocket) - 1);
+    strncpy(peer_addr.sun_path, path, sizeof(peer_addr.sun_path) - 1);
 
     peer_addr_size = sizeof(struct sockaddr_un);
     if (connect(Fd, (struct sockaddr *) &peer_addr, peer_addr_size) < 0)
@@ -344,6 +349,26 @@ int Connection::Start(const std::string &name) {
     return Impl->Rpc();
 }
 
+int Connection::ApplySpec(const std::string &name,
+                          const std::vector<std::pair<std::string, std::string>> &properties,
+                          const std::vector<std::string> &volumes,
+                          bool start) {
+    auto req = Impl->Req.mutable_applyspec();
+
+    req->set_name(name);
+    for (const auto &kv: properties) {
+        auto prop = req->add_properties();
+        prop->set_name(kv.first);
+        prop->set_value(kv.second);
+    }
+    for (const auto &path: volumes)
+        req->add_volumes(path);
+    if (start)
+        req->set_start(true);
+
+    return Impl->Rpc();
+}
+
 int Connection::Stop(const std::string &name, int timeout) {
     auto stop = Impl->Req.mutable_stop();
 
@@ -367,6 +392,37 @@ int Connection::Pause(const std::string &name) {
     return Impl->Rpc();
 }
 
+static void GetPhases(const rpc::TContainerResponse &rsp,
+                      std::vector<std::pair<std::string, uint64_t>> *phases) {
+    if (!phases)
+        return;
+    phases->clear();
+    for (auto &phase: rsp.phases())
+        phases->emplace_back(phase.name(), phase.time_ms());
+}
+
+int Connection::Checkpoint(const std::string &name, const std::string &path,
+                           std::vector<std::pair<std::string, uint64_t>> *phases) {
+    auto req = Impl->Req.mutable_checkpoint();
+    req->set_name(name);
+    req->set_path(path);
+
+    auto ret = Impl->Rpc();
+    GetPhases(Impl->Rsp, phases);
+    return ret;
+}
+
+int Connection::Restore(const std::string &name, const std::string &path,
+                        std::vector<std::pair<std::string, uint64_t>> *phases) {
+    auto req = Impl->Req.mutable_restore();
+    req->set_name(name);
+    req->set_path(path);
+
+    auto ret = Impl->Rpc();
+    GetPhases(Impl->Rsp, phases);
+    return ret;
+}
+
 int Connection::Resume(const std::string &name) {
     Impl->Req.mutable_resume()->set_name(name);
 
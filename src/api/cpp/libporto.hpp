@@ -48,11 +48,24 @@ public:
     int Destroy(const std::string &name);
 
     int Start(const std::string &name);
+
+    /* create, configure and optionally start with one request */
+    int ApplySpec(const std::string &name,
+                  const std::vector<std::pair<std::string, std::string>> &properties,
+                  const std::vector<std::string> &volumes = {},
+                  bool start = false);
     int Stop(const std::string &name, int timeout = -1);
     int Kill(const std::string &name, int sig);
     int Pause(const std::string &name);
     int Resume(const std::string &name);
 
+    /* dump container with criu into new directory and stop it */
+    int Checkpoint(const std::string &name, const std::string &path,
+                   std::vector<std::pair<std::string, uint64_t>> *phases = nullptr);
+    /* create container from checkpoint image and restore its tasks */
+    int Restore(const std::string &name, const std::string &path,
+                std::vector<std::pair<std::string, uint64_t>> *phases = nullptr);
+
     int WaitContainers(const std::vector<std::string> &containers,
                        std::string &name, int timeout);
 
@@ -3,11 +3,15 @@
 package porto
 
 import (
+	"bufio"
+	"context"
 	"encoding/binary"
+	"errors"
 	"fmt"
 	"io"
 	"math"
 	"net"
+	"sync"
 	"syscall"
 	"time"
 
@@ -19,44 +23,29 @@ import (
 const portoSocket = "/run/portod.socket"
 
 func sendData(conn io.Writer, data []byte) error {
-	// First we have to send actual data size,
-	// then the data itself
-	buf := make([]byte, 64)
+	// Size and data go in one write
+	buf := make([]byte, binary.MaxVarintLen64, binary.MaxVarintLen64+len(data))
 	len := binary.PutUvarint(buf, uint64(len(data)))
-	_, err := conn.Write(buf[:len])
-	if err != nil {
-		return err
-	}
-	_, err = conn.Write(data)
+	_, err := conn.Write(append(buf[:len], data...))
 	return err
 }
 
-func recvData(conn io.Reader) ([]byte, error) {
-	buf := make([]byte, 1024*1024)
+type byteReader interface {
+	io.Reader
+	io.ByteReader
+}
 
-	size, err := conn.Read(buf)
+func recvData(conn byteReader) ([]byte, error) {
+	// conn is buffered, so reading varint bytewise is cheap
+	exp, err := binary.ReadUvarint(conn)
 	if err != nil {
 		return nil, err
 	}
 
-	exp, shift := binary.Uvarint(buf)
-
-	// length of result is exp,
-	// so preallocate a buffer for it.
-	var ret = make([]byte, exp)
-	// bytes after an encoded uint64 and up to len
-	// are belong to a packed structure, so copy them
-	copy(ret, buf[shift:size])
-
-	// we don't need to check that
-	// size > shift, as we ask to read enough data
-	// to decode uint64. Otherwise we would have an error before.
-	for pos := size - shift; uint64(pos) < exp; {
-		n, err := conn.Read(ret[pos:])
-		if err != nil {
-			return nil, err
-		}
-		pos += n
+	ret := make([]byte, exp)
+	_, err = io.ReadFull(conn, ret)
+	if err != nil {
+		return nil, err
 	}
 
 	return ret, nil
@@ -97,9 +86,14 @@ func (e *Error) Error() string {
 type API interface {
 	GetVersion() (string, string, error)
 
+	// Error of the last request made through this API value
 	GetLastError() rpc.EError
 	GetLastErrorMessage() string
 
+	// WithContext returns API which shares connections with this one
+	// and applies deadline and cancellation of ctx to every request.
+	WithContext(ctx context.Context) API
+
 	// ContainerAPI
 	Create(name string) error
 	CreateWeak(name string) error
@@ -119,6 +113,12 @@ type API interface {
 
 	Get(containers []string, variables []string) (map[string]map[string]TPortoGetResponse, error)
 
+	// GetMany splits containers into requests of batch names and
+	// runs them in parallel over the connection pool.
+	GetMany(containers []string, variables []string, batch int) (map[string]map[string]TPortoGetResponse, error)
+	// ListGet is GetMany for all containers
+	ListGet(variables []string, batch int) (map[string]map[string]TPortoGetResponse, error)
+
 	GetProperty(name string, property string) (string, error)
 	SetProperty(name string, property string, value string) error
 
@@ -143,37 +143,148 @@ type API interface {
 	Close() error
 }
 
+type socketConn struct {
+	conn   net.Conn
+	reader *bufio.Reader
+}
+
+// Pool of up to size connections, goroutine-safe
+type connPool struct {
+	idle   chan *socketConn
+	slots  chan struct{}
+	mutex  sync.Mutex
+	closed bool
+}
+
 type portoConnection struct {
-	conn net.Conn
-	err  rpc.EError
-	msg  string
+	pool *connPool
+	ctx  context.Context
+
+	mutex sync.Mutex
+	err   rpc.EError
+	msg   string
 }
 
-//Connect establishes connection to a Porto daemon via unix socket.
-//Close must be called when the API is not needed anymore.
+// Connect establishes connection to a Porto daemon via unix socket.
+// Close must be called when the API is not needed anymore.
 func Connect() (API, error) {
-	c, err := net.Dial("unix", portoSocket)
+	return ConnectPool(1)
+}
+
+// ConnectPool returns goroutine-safe API which keeps up to size
+// connections, concurrent requests use different connections.
+// Weak containers are bound to connection, use them only with size 1.
+func ConnectPool(size int) (API, error) {
+	if size < 1 {
+		size = 1
+	}
+
+	pool := &connPool{
+		idle:  make(chan *socketConn, size),
+		slots: make(chan struct{}, size),
+	}
+
+	// fail early if porto isn't running
+	sock, err := pool.get(context.Background())
 	if err != nil {
 		return nil, err
 	}
+	pool.put(sock, false)
 
-	ret := new(portoConnection)
-	ret.conn = c
-	return ret, nil
+	return &portoConnection{pool: pool, ctx: context.Background()}, nil
+}
+
+func (pool *connPool) dial(ctx context.Context) (*socketConn, error) {
+	var dialer net.Dialer
+	for {
+		c, err := dialer.DialContext(ctx, "unix", portoSocket)
+		if err == nil {
+			return &socketConn{conn: c, reader: bufio.NewReader(c)}, nil
+		}
+		// listen backlog is full while pool connects concurrently
+		if errors.Is(err, syscall.EAGAIN) && ctx.Err() == nil {
+			time.Sleep(10 * time.Millisecond)
+			continue
+		}
+		<-pool.slots
+		return nil, err
+	}
+}
+
+func (pool *connPool) get(ctx context.Context) (*socketConn, error) {
+	select {
+	case sock := <-pool.idle:
+		return sock, nil
+	default:
+	}
+
+	select {
+	case sock := <-pool.idle:
+		return sock, nil
+	case pool.slots <- struct{}{}:
+		return pool.dial(ctx)
+	case <-ctx.Done():
+		return nil, ctx.Err()
+	}
+}
+
+func (pool *connPool) put(sock *socketConn, broken bool) {
+	pool.mutex.Lock()
+	closed := pool.closed
+	pool.mutex.Unlock()
+
+	if broken || closed {
+		sock.conn.Close()
+		<-pool.slots
+		return
+	}
+	pool.idle <- sock
+}
+
+func (pool *connPool) close() error {
+	pool.mutex.Lock()
+	pool.closed = true
+	pool.mutex.Unlock()
+
+	// connections in use are closed when returned
+	for {
+		select {
+		case sock := <-pool.idle:
+			sock.conn.Close()
+			<-pool.slots
+		default:
+			return nil
+		}
+	}
 }
 
 func (conn *portoConnection) Close() error {
-	return conn.conn.Close()
+	return conn.pool.close()
+}
+
+func (conn *portoConnection) WithContext(ctx context.Context) API {
+	return &portoConnection{pool: conn.pool, ctx: ctx}
 }
 
 func (conn *portoConnection) GetLastError() rpc.EError {
+	conn.mutex.Lock()
+	defer conn.mutex.Unlock()
 	return conn.err
 }
 
 func (conn *portoConnection) GetLastErrorMessage() string {
+	conn.mutex.Lock()
+	defer conn.mutex.Unlock()
 	return conn.msg
 }
 
+func (conn *portoConnection) setLastError(err rpc.EError, msg string) {
+	conn.mutex.Lock()
+	conn.err = err
+	conn.msg = msg
+	conn.mutex.Unlock()
+}
+
 func (conn *portoConnection) GetVersion() (string, string, error) {
 	req := &rpc.TContainerRequest{
 		Version: new(rpc.TVersionRequest),
@@ -186,21 +297,58 @@ func (conn *portoConnection) GetVersion() (string, string, error) {
 	return resp.GetVersion().GetTag(), resp.GetVersion().GetRevision(), nil
 }
 
+func (sock *socketConn) roundTrip(ctx context.Context, data []byte) ([]byte, error) {
+	deadline, hasDeadline := ctx.Deadline()
+	err := sock.conn.SetDeadline(deadline)
+	if err != nil {
+		return nil, err
+	}
+
+	// cancellation interrupts blocked read or write
+	done := make(chan struct{})
+	defer close(done)
+	if ctx.Done() != nil {
+		go func() {
+			select {
+			case <-ctx.Done():
+				sock.conn.SetDeadline(time.Unix(1, 0))
+			case <-done:
+			}
+		}()
+	}
+
+	err = sendData(sock.conn, data)
+	if err == nil {
+		data, err = recvData(sock.reader)
+	}
+
+	if err != nil && ctx.Err() != nil {
+		return nil, ctx.Err()
+	}
+	// socket deadline might fire before context timer
+	if ne, ok := err.(net.Error); ok && ne.Timeout() && hasDeadline {
+		return nil, context.DeadlineExceeded
+	}
+	return data, err
+}
+
 func (conn *portoConnection) performRequest(req *rpc.TContainerRequest) (*rpc.TContainerResponse, error) {
-	conn.err = 0
-	conn.msg = ""
+	conn.setLastError(0, "")
 
 	data, err := proto.Marshal(req)
 	if err != nil {
 		return nil, err
 	}
 
-	err = sendData(conn.conn, data)
+	sock, err := conn.pool.get(conn.ctx)
 	if err != nil {
 		return nil, err
 	}
 
-	data, err = recvData(conn.conn)
+	data, err = sock.roundTrip(conn.ctx, data)
+
+	// connection with unfinished request is out of sync
+	conn.pool.put(sock, err != nil)
 	if err != nil {
 		return nil, err
 	}
@@ -212,14 +360,13 @@ func (conn *portoConnection) performRequest(req *rpc.TContainerRequest) (*rpc.TC
 		return nil, err
 	}
 
-	conn.err = resp.GetError()
-	conn.msg = resp.GetErrorMsg()
+	conn.setLastError(resp.GetError(), resp.GetErrorMsg())
 
 	if resp.GetError() != rpc.EError_Success {
 		return resp, &Error{
-			Errno:   conn.err,
-			ErrName: rpc.EError_name[int32(conn.err)],
-			Message: conn.msg,
+			Errno:   resp.GetError(),
+			ErrName: rpc.EError_name[int32(resp.GetError())],
+			Message: resp.GetErrorMsg(),
 		}
 	}
 
@@ -413,6 +560,57 @@ func (conn *portoConnection) Get(containers []string, variables []string) (ret m
 	return ret, err
 }
 
+func (conn *portoConnection) GetMany(containers []string, variables []string, batch int) (map[string]map[string]TPortoGetResponse, error) {
+	if batch < 1 {
+		batch = len(containers)
+	}
+
+	var wg sync.WaitGroup
+	var mutex sync.Mutex
+	var firstErr error
+	ret := make(map[string]map[string]TPortoGetResponse)
+
+	for start := 0; start < len(containers); start += batch {
+		end := start + batch
+		if end > len(containers) {
+			end = len(containers)
+		}
+
+		wg.Add(1)
+		go func(names []string) {
+			defer wg.Done()
+			// private API value: last error isn't shared between batches
+			resp, err := conn.WithContext(conn.ctx).Get(names, variables)
+
+			mutex.Lock()
+			defer mutex.Unlock()
+			if err != nil {
+				if firstErr == nil {
+					firstErr = err
+				}
+				return
+			}
+			for name, values := range resp {
+				ret[name] = values
+			}
+		}(containers[start:end])
+	}
+
+	wg.Wait()
+	if firstErr != nil {
+		return nil, firstErr
+	}
+	return ret, nil
+}
+
+func (conn *portoConnection) ListGet(variables []string, batch int) (map[string]map[string]TPortoGetResponse, error) {
+	containers, err := conn.List()
+	if err != nil {
+		return nil, err
+	}
+	return conn.GetMany(containers, variables, batch)
+}
+
 func (conn *portoConnection) GetProperty(name string, property string) (string, error) {
 	req := &rpc.TContainerRequest{
 		GetProperty: &rpc.TContainerGetPropertyRequest{
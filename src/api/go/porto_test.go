@@ -2,11 +2,14 @@ package porto
 
 import (
 	"bytes"
+	"context"
 	"crypto/rand"
 	"os"
 	"os/exec"
+	"sync"
 	"syscall"
 	"testing"
+	"time"
 
 	"./rpc"
 )
@@ -53,7 +56,7 @@ func TestGetVersion(t *testing.T) {
 	defer conn.Close()
 	maj, min, err := conn.GetVersion()
 	FailOnError(t, conn, err)
-	t.Logf("Porto version %d.%d", maj, min)
+	t.Logf("Porto version %s.%s", maj, min)
 }
 
 func TestPlist(t *testing.T) {
@@ -119,6 +122,44 @@ func TestList(t *testing.T) {
 	t.FailNow()
 }
 
+func TestPoolConcurrent(t *testing.T) {
+	conn, err := ConnectPool(4)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer conn.Close()
+
+	var wg sync.WaitGroup
+	for i := 0; i < 16; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < 100; j++ {
+				if _, err := conn.GetData("/", "state"); err != nil {
+					t.Error(err)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
+
+func TestListGet(t *testing.T) {
+	conn, err := ConnectPool(4)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer conn.Close()
+
+	resp, err := conn.ListGet([]string{"state"}, 1)
+	FailOnError(t, conn, err)
+	if resp[testContainer]["state"].Value != "stopped" {
+		t.Error("Got a wrong state value")
+		t.FailNow()
+	}
+}
+
 func TestSetProperty(t *testing.T) {
 	conn := ConnectToPorto(t)
 	defer conn.Close()
@@ -154,6 +195,23 @@ func TestResume(t *testing.T) {
 	FailOnError(t, conn, conn.Resume(testContainer))
 }
 
+func TestContextDeadline(t *testing.T) {
+	conn := ConnectToPorto(t)
+	defer conn.Close()
+
+	ctx, cancel := context.WithTimeout(context.Background(), 100*time.Millisecond)
+	defer cancel()
+
+	_, err := conn.WithContext(ctx).Wait([]string{testContainer}, -1)
+	if err != context.DeadlineExceeded {
+		t.Errorf("Unexpected wait result: %v", err)
+	}
+
+	// connection is usable after cancelled request
+	_, err = conn.List()
+	FailOnError(t, conn, err)
+}
+
 func TestKill(t *testing.T) {
 	conn := ConnectToPorto(t)
 	defer conn.Close()
@@ -26,6 +26,10 @@ It has these top-level messages:
 	TConvertPathRequest
 	TContainerGetRequest
 	TContainerWaitRequest
+	TContainerProperty
+	TContainerSpecRequest
+	TContainerCheckpointRequest
+	TContainerRestoreRequest
 	TContainerRequest
 	TContainerListResponse
 	TContainerGetPropertyResponse
@@ -36,6 +40,7 @@ It has these top-level messages:
 	TContainerGetResponse
 	TContainerWaitResponse
 	TConvertPathResponse
+	TContainerPhase
 	TContainerResponse
 	TVolumeProperty
 	TVolumePropertyDescription
@@ -108,6 +113,8 @@ const (
 	EError_VolumeNotLinked    EError = 17
 	EError_LayerAlreadyExists EError = 18
 	EError_LayerNotFound      EError = 19
+	// Client exceeded request rate or concurrency limit. Retry later.
+	EError_Throttled EError = 20
 	// Reserved error code used by Porto internals. Can't be returned to a user.
 	EError_Queued EError = 1000
 )
@@ -133,6 +140,7 @@ var EError_name = map[int32]string{
 	17:   "VolumeNotLinked",
 	18:   "LayerAlreadyExists",
 	19:   "LayerNotFound",
+	20:   "Throttled",
 	1000: "Queued",
 }
 var EError_value = map[string]int32{
@@ -156,6 +164,7 @@ var EError_value = map[string]int32{
 	"VolumeNotLinked":        17,
 	"LayerAlreadyExists":     18,
 	"LayerNotFound":          19,
+	"Throttled":              20,
 	"Queued":                 1000,
 }
 
@@ -496,6 +505,123 @@ func (m *TContainerWaitRequest) GetTimeout() uint32 {
 	return 0
 }
 
+type TContainerProperty struct {
+	Name             *string `protobuf:"bytes,1,req,name=name" json:"name,omitempty"`
+	Value            *string `protobuf:"bytes,2,req,name=value" json:"value,omitempty"`
+	XXX_unrecognized []byte  `json:"-"`
+}
+
+func (m *TContainerProperty) Reset()         { *m = TContainerProperty{} }
+func (m *TContainerProperty) String() string { return proto.CompactTextString(m) }
+func (*TContainerProperty) ProtoMessage()    {}
+
+func (m *TContainerProperty) GetName() string {
+	if m != nil && m.Name != nil {
+		return *m.Name
+	}
+	return ""
+}
+
+func (m *TContainerProperty) GetValue() string {
+	if m != nil && m.Value != nil {
+		return *m.Value
+	}
+	return ""
+}
+
+// Create, configure and optionally start container in one request.
+// Either everything is applied or container is destroyed.
+type TContainerSpecRequest struct {
+	Name             *string               `protobuf:"bytes,1,req,name=name" json:"name,omitempty"`
+	Properties       []*TContainerProperty `protobuf:"bytes,2,rep,name=properties" json:"properties,omitempty"`
+	Volumes          []string              `protobuf:"bytes,3,rep,name=volumes" json:"volumes,omitempty"`
+	Start            *bool                 `protobuf:"varint,4,opt,name=start" json:"start,omitempty"`
+	XXX_unrecognized []byte                `json:"-"`
+}
+
+func (m *TContainerSpecRequest) Reset()         { *m = TContainerSpecRequest{} }
+func (m *TContainerSpecRequest) String() string { return proto.CompactTextString(m) }
+func (*TContainerSpecRequest) ProtoMessage()    {}
+
+func (m *TContainerSpecRequest) GetName() string {
+	if m != nil && m.Name != nil {
+		return *m.Name
+	}
+	return ""
+}
+
+func (m *TContainerSpecRequest) GetProperties() []*TContainerProperty {
+	if m != nil {
+		return m.Properties
+	}
+	return nil
+}
+
+func (m *TContainerSpecRequest) GetVolumes() []string {
+	if m != nil {
+		return m.Volumes
+	}
+	return nil
+}
+
+func (m *TContainerSpecRequest) GetStart() bool {
+	if m != nil && m.Start != nil {
+		return *m.Start
+	}
+	return false
+}
+
+// Dump running container with CRIU into directory and stop it.
+type TContainerCheckpointRequest struct {
+	Name *string `protobuf:"bytes,1,req,name=name" json:"name,omitempty"`
+	// absolute path of new directory for the image
+	Path             *string `protobuf:"bytes,2,req,name=path" json:"path,omitempty"`
+	XXX_unrecognized []byte  `json:"-"`
+}
+
+func (m *TContainerCheckpointRequest) Reset()         { *m = TContainerCheckpointRequest{} }
+func (m *TContainerCheckpointRequest) String() string { return proto.CompactTextString(m) }
+func (*TContainerCheckpointRequest) ProtoMessage()    {}
+
+func (m *TContainerCheckpointRequest) GetName() string {
+	if m != nil && m.Name != nil {
+		return *m.Name
+	}
+	return ""
+}
+
+func (m *TContainerCheckpointRequest) GetPath() string {
+	if m != nil && m.Path != nil {
+		return *m.Path
+	}
+	return ""
+}
+
+// Create container from checkpoint image and resume its tasks.
+type TContainerRestoreRequest struct {
+	Name             *string `protobuf:"bytes,1,req,name=name" json:"name,omitempty"`
+	Path             *string `protobuf:"bytes,2,req,name=path" json:"path,omitempty"`
+	XXX_unrecognized []byte  `json:"-"`
+}
+
+func (m *TContainerRestoreRequest) Reset()         { *m = TContainerRestoreRequest{} }
+func (m *TContainerRestoreRequest) String() string { return proto.CompactTextString(m) }
+func (*TContainerRestoreRequest) ProtoMessage()    {}
+
+func (m *TContainerRestoreRequest) GetName() string {
+	if m != nil && m.Name != nil {
+		return *m.Name
+	}
+	return ""
+}
+
+func (m *TContainerRestoreRequest) GetPath() string {
+	if m != nil && m.Path != nil {
+		return *m.Path
+	}
+	return ""
+}
+
 type TContainerRequest struct {
 	Create               *TContainerCreateRequest       `protobuf:"bytes,1,opt,name=create" json:"create,omitempty"`
 	Destroy              *TContainerDestroyRequest      `protobuf:"bytes,2,opt,name=destroy" json:"destroy,omitempty"`
@@ -514,6 +640,9 @@ type TContainerRequest struct {
 	Get                  *TContainerGetRequest          `protobuf:"bytes,15,opt,name=get" json:"get,omitempty"`
 	Wait                 *TContainerWaitRequest         `protobuf:"bytes,16,opt,name=wait" json:"wait,omitempty"`
 	CreateWeak           *TContainerCreateRequest       `protobuf:"bytes,17,opt,name=createWeak" json:"createWeak,omitempty"`
+	ApplySpec            *TContainerSpecRequest         `protobuf:"bytes,18,opt,name=applySpec" json:"applySpec,omitempty"`
+	Checkpoint           *TContainerCheckpointRequest   `protobuf:"bytes,19,opt,name=checkpoint" json:"checkpoint,omitempty"`
+	Restore              *TContainerRestoreRequest      `protobuf:"bytes,20,opt,name=restore" json:"restore,omitempty"`
 	ListVolumeProperties *TVolumePropertyListRequest    `protobuf:"bytes,103,opt,name=listVolumeProperties" json:"listVolumeProperties,omitempty"`
 	CreateVolume         *TVolumeCreateRequest          `protobuf:"bytes,104,opt,name=createVolume" json:"createVolume,omitempty"`
 	LinkVolume           *TVolumeLinkRequest            `protobuf:"bytes,105,opt,name=linkVolume" json:"linkVolume,omitempty"`
@@ -651,6 +780,27 @@ func (m *TContainerRequest) GetCreateWeak() *TContainerCreateRequest {
 	return nil
 }
 
+func (m *TContainerRequest) GetApplySpec() *TContainerSpecRequest {
+	if m != nil {
+		return m.ApplySpec
+	}
+	return nil
+}
+
+func (m *TContainerRequest) GetCheckpoint() *TContainerCheckpointRequest {
+	if m != nil {
+		return m.Checkpoint
+	}
+	return nil
+}
+
+func (m *TContainerRequest) GetRestore() *TContainerRestoreRequest {
+	if m != nil {
+		return m.Restore
+	}
+	return nil
+}
+
 func (m *TContainerRequest) GetListVolumeProperties() *TVolumePropertyListRequest {
 	if m != nil {
 		return m.ListVolumeProperties
@@ -1012,6 +1162,30 @@ func (m *TConvertPathResponse) GetPath() string {
 	return ""
 }
 
+type TContainerPhase struct {
+	Name             *string `protobuf:"bytes,1,req,name=name" json:"name,omitempty"`
+	TimeMs           *uint64 `protobuf:"varint,2,req,name=time_ms" json:"time_ms,omitempty"`
+	XXX_unrecognized []byte  `json:"-"`
+}
+
+func (m *TContainerPhase) Reset()         { *m = TContainerPhase{} }
+func (m *TContainerPhase) String() string { return proto.CompactTextString(m) }
+func (*TContainerPhase) ProtoMessage()    {}
+
+func (m *TContainerPhase) GetName() string {
+	if m != nil && m.Name != nil {
+		return *m.Name
+	}
+	return ""
+}
+
+func (m *TContainerPhase) GetTimeMs() uint64 {
+	if m != nil && m.TimeMs != nil {
+		return *m.TimeMs
+	}
+	return 0
+}
+
 type TContainerResponse struct {
 	Error *EError `protobuf:"varint,1,req,name=error,enum=rpc.EError" json:"error,omitempty"`
 	// Optional error message
@@ -1029,7 +1203,9 @@ type TContainerResponse struct {
 	Volume             *TVolumeDescription             `protobuf:"bytes,13,opt,name=volume" json:"volume,omitempty"`
 	Layers             *TLayerListResponse             `protobuf:"bytes,14,opt,name=layers" json:"layers,omitempty"`
 	ConvertPath        *TConvertPathResponse           `protobuf:"bytes,15,opt,name=convertPath" json:"convertPath,omitempty"`
-	XXX_unrecognized   []byte                          `json:"-"`
+	// time of each step of checkpoint or restore
+	Phases           []*TContainerPhase `protobuf:"bytes,16,rep,name=phases" json:"phases,omitempty"`
+	XXX_unrecognized []byte             `json:"-"`
 }
 
 func (m *TContainerResponse) Reset()         { *m = TContainerResponse{} }
@@ -1141,6 +1317,13 @@ func (m *TContainerResponse) GetConvertPath() *TConvertPathResponse {
 	return nil
 }
 
+func (m *TContainerResponse) GetPhases() []*TContainerPhase {
+	if m != nil {
+		return m.Phases
+	}
+	return nil
+}
+
 type TVolumeProperty struct {
 	Name             *string `protobuf:"bytes,1,req,name=name" json:"name,omitempty"`
 	Value            *string `protobuf:"bytes,2,req,name=value" json:"value,omitempty"`
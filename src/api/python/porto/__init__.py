@@ -1,2 +1,7 @@
+import sys
+
 from . import exceptions
 from .api import Connection
+
+if sys.version_info >= (3, 5):
+    from .aio import AsyncConnection
@@ -0,0 +1,211 @@
+import asyncio
+
+from . import rpc_pb2
+from . import exceptions
+from .api import _EncodeMessage, _DecodeVarint32, _ParseValue, _FormatValue, _ParseGetResponse
+
+__all__ = ['AsyncConnection']
+
+
+class _AsyncSocket(object):
+    """Single asyncio connection to portod, one request in flight."""
+
+    def __init__(self, socket_path):
+        self.socket_path = socket_path
+        self.reader = None
+        self.writer = None
+
+    async def connect(self):
+        self.disconnect()
+        try:
+            self.reader, self.writer = await asyncio.open_unix_connection(self.socket_path)
+        except OSError as e:
+            raise exceptions.SocketError("Cannot connect to {}: {}".format(self.socket_path, e))
+
+    def disconnect(self):
+        if self.writer is not None:
+            self.writer.close()
+        self.reader = None
+        self.writer = None
+
+    async def _recv_message(self):
+        hdr = bytearray()
+        while True:
+            # StreamReader is buffered, this does not cost a syscall per byte
+            b = await self.reader.readexactly(1)
+            hdr += b
+            if not (b[0] & 0x80):
+                break
+            if len(hdr) >= 5:
+                raise IOError('Too many bytes when decoding varint.')
+        length = _DecodeVarint32(hdr, 0)[0]
+        return await self.reader.readexactly(length)
+
+    async def call(self, data, timeout):
+        if self.writer is None:
+            await self.connect()
+
+        try:
+            self.writer.write(data)
+            await self.writer.drain()
+            return await asyncio.wait_for(self._recv_message(), timeout)
+        except asyncio.TimeoutError:
+            # late response would be taken as answer to the next request
+            self.disconnect()
+            raise exceptions.SocketTimeout("Got timeout: {}".format(timeout))
+        except (OSError, IOError, asyncio.IncompleteReadError) as e:
+            self.disconnect()
+            raise exceptions.SocketError("Socket error: {}".format(e))
+        except BaseException:
+            # cancelled or interrupted in the middle of request
+            self.disconnect()
+            raise
+
+
+class AsyncConnection(object):
+    """
+    Asyncio client: up to pool_size requests are in flight at once,
+    each on its own connection. Weak containers are not supported
+    because they are bound to a connection.
+
+    Example:
+    conn = AsyncConnection()
+    states = await asyncio.gather(*[conn.GetData(c, 'state') for c in await conn.List()])
+    await conn.close()
+    """
+
+    def __init__(self, socket_path='/run/portod.socket', timeout=5, pool_size=16):
+        self.socket_path = socket_path
+        self.timeout = timeout
+        self.pool_size = max(pool_size, 1)
+        self.pool = []
+        self.idle = None
+
+    def _get_idle(self):
+        if self.idle is None:
+            # created lazily to bind to the running event loop
+            self.idle = asyncio.Queue()
+            for _ in range(self.pool_size):
+                conn = _AsyncSocket(self.socket_path)
+                self.pool.append(conn)
+                self.idle.put_nowait(conn)
+        return self.idle
+
+    async def connect(self):
+        idle = self._get_idle()
+        conn = await idle.get()
+        try:
+            await conn.connect()
+        finally:
+            idle.put_nowait(conn)
+
+    async def close(self):
+        for conn in self.pool:
+            conn.disconnect()
+
+    async def call(self, request, timeout=None):
+        if timeout is None:
+            timeout = self.timeout
+        data = _EncodeMessage(request.SerializeToString())
+
+        idle = self._get_idle()
+        conn = await idle.get()
+        try:
+            data = await conn.call(data, timeout)
+        finally:
+            idle.put_nowait(conn)
+
+        resp = rpc_pb2.TContainerResponse()
+        resp.ParseFromString(data)
+
+        if resp.error != rpc_pb2.Success:
+            raise exceptions.EError.Create(resp.error, resp.errorMsg)
+
+        return resp
+
+    async def List(self):
+        request = rpc_pb2.TContainerRequest()
+        request.list.CopyFrom(rpc_pb2.TContainerListRequest())
+        return list((await self.call(request)).list.name)
+
+    async def Plist(self):
+        request = rpc_pb2.TContainerRequest()
+        request.propertyList.CopyFrom(rpc_pb2.TContainerPropertyListRequest())
+        return [item.name for item in (await self.call(request)).propertyList.list]
+
+    async def Dlist(self):
+        request = rpc_pb2.TContainerRequest()
+        request.dataList.CopyFrom(rpc_pb2.TContainerDataListRequest())
+        return [item.name for item in (await self.call(request)).dataList.list]
+
+    async def Create(self, name):
+        request = rpc_pb2.TContainerRequest()
+        request.create.name = name
+        await self.call(request)
+
+    async def Destroy(self, name):
+        request = rpc_pb2.TContainerRequest()
+        request.destroy.name = name
+        await self.call(request)
+
+    async def Start(self, name):
+        request = rpc_pb2.TContainerRequest()
+        request.start.name = name
+        await self.call(request)
+
+    async def Stop(self, name, timeout_s=None):
+        request = rpc_pb2.TContainerRequest()
+        request.stop.name = name
+        if timeout_s is not None and timeout_s >= 0:
+            request.stop.timeout_ms = timeout_s * 1000
+        else:
+            timeout_s = 30
+        await self.call(request, max(self.timeout, timeout_s + 1))
+
+    async def Kill(self, name, sig):
+        request = rpc_pb2.TContainerRequest()
+        request.kill.name = name
+        request.kill.sig = sig
+        await self.call(request)
+
+    async def Pause(self, name):
+        request = rpc_pb2.TContainerRequest()
+        request.pause.name = name
+        await self.call(request)
+
+    async def Resume(self, name):
+        request = rpc_pb2.TContainerRequest()
+        request.resume.name = name
+        await self.call(request)
+
+    async def GetProperty(self, name, property):
+        request = rpc_pb2.TContainerRequest()
+        request.getProperty.name = name
+        request.getProperty.property = property
+        return _ParseValue((await self.call(request)).getProperty.value)
+
+    async def SetProperty(self, name, property, value):
+        request = rpc_pb2.TContainerRequest()
+        request.setProperty.name = name
+        request.setProperty.property = property
+        request.setProperty.value = _FormatValue(value)
+        await self.call(request)
+
+    async def GetData(self, name, data):
+        request = rpc_pb2.TContainerRequest()
+        request.getData.name = name
+        request.getData.data = data
+        return _ParseValue((await self.call(request)).getData.value)
+
+    async def Get(self, containers, variables):
+        request = rpc_pb2.TContainerRequest()
+        request.get.name.extend(containers)
+        request.get.variable.extend(variables)
+        return _ParseGetResponse(await self.call(request))
+
+    async def Wait(self, containers, timeout=None):
+        request = rpc_pb2.TContainerRequest()
+        request.wait.name.extend(containers)
+        if timeout is not None and timeout >= 0:
+            request.wait.timeout = timeout
+        return list((await self.call(request, None)).wait.name)
@@ -1,4 +1,5 @@
 import os
+import numbers
 import socket
 import threading
 
@@ -12,16 +13,14 @@ __all__ = ['Connection']
 def _VarintEncoder():
     """Return an encoder for a basic varint value (does not include tag)."""
 
-    local_chr = chr
-
     def EncodeVarint(write, value):
         bits = value & 0x7f
         value >>= 7
         while value:
-            write(local_chr(0x80 | bits))
+            write(0x80 | bits)
             bits = value & 0x7f
             value >>= 7
-        return write(local_chr(bits))
+        return write(bits)
 
     return EncodeVarint
 
@@ -35,16 +34,14 @@ def _VarintDecoder(mask):
     returned, e.g. to limit them to 32 bits.  The returned decoder does not
     take the usual "end" parameter -- the caller is expected to do bounds checking
     after the fact (often the caller can defer such checking until later).  The
-    decoder returns a (value, new_pos) pair.
+    decoder returns a (value, new_pos) pair. Buffer must be a bytearray.
     """
 
-    local_ord = ord
-
     def DecodeVarint(buffer, pos):
         result = 0
         shift = 0
         while 1:
-            b = local_ord(buffer[pos])
+            b = buffer[pos]
             result |= ((b & 0x7f) << shift)
             pos += 1
             if not (b & 0x80):
@@ -58,19 +55,80 @@ def _VarintDecoder(mask):
 _DecodeVarint = _VarintDecoder((1 << 64) - 1)
 _DecodeVarint32 = _VarintDecoder((1 << 32) - 1)
 
+
+def _EncodeMessage(data):
+    """Return message prefixed with varint length."""
+    buf = bytearray()
+    _EncodeVarint(buf.append, len(data))
+    buf += data
+    return bytes(buf)
+
+
+def _DecodeMessage(buf):
+    """Return (begin, end) of the first complete message in bytearray or None."""
+    for pos in range(min(len(buf), 5)):
+        if not (buf[pos] & 0x80):
+            length, begin = _DecodeVarint32(buf, 0)
+            if len(buf) < begin + length:
+                return None
+            return (begin, begin + length)
+    if len(buf) >= 5:
+        raise IOError('Too many bytes when decoding varint.')
+    return None
+
+
+def _ParseValue(value):
+    if value == 'false':
+        return False
+    elif value == 'true':
+        return True
+    return value
+
+
+def _FormatValue(value):
+    if value is False:
+        return 'false'
+    elif value is True:
+        return 'true'
+    elif value is None:
+        return ''
+    elif isinstance(value, numbers.Integral):
+        return str(value)
+    return value
+
+
+def _ParseGetResponse(resp):
+    res = {}
+    for container in resp.get.list:
+        var = {}
+        for kv in container.keyval:
+            if kv.HasField('error'):
+                var[kv.variable] = exceptions.EError.Create(kv.error, kv.errorMsg)
+                continue
+            var[kv.variable] = _ParseValue(kv.value)
+
+        res[container.name] = var
+
+    return res
+
 ################################################################################
 
+_RECV_CHUNK = 65536
 
-class _RPC(object):
-    def __init__(self, socket_path, timeout, socket_constructor, lock_constructor):
-        self.lock = lock_constructor()
+
+class _Socket(object):
+    """Single connection to portod, reads responses through a buffer."""
+
+    def __init__(self, socket_path, timeout, socket_constructor):
         self.socket_path = socket_path
         self.timeout = timeout
         self.socket_timeout = timeout
         self.socket_constructor = socket_constructor
         self.sock = None
+        self.buf = bytearray()
 
     def connect(self):
+        self.disconnect()
         self.sock = self.socket_constructor(socket.AF_UNIX, socket.SOCK_STREAM)
         self.sock.settimeout(self.socket_timeout)
         try:
@@ -83,73 +141,117 @@ class _RPC(object):
         if self.sock is not None:
             self.sock.close()
         self.sock = None
+        self.buf = bytearray()
+
+    def _settimeout(self, timeout):
+        if timeout != self.socket_timeout:
+            if self.sock is not None:
+                self.sock.settimeout(timeout)
+            self.socket_timeout = timeout
 
     def _sendall(self, data, flags=0):
         try:
             return self.sock.sendall(data, flags)
         except socket.timeout:
+            # partial request may be sent, connection is out of sync
+            self.disconnect()
             raise exceptions.SocketTimeout("Got timeout: {}".format(self.socket_timeout))
         except socket.error as e:
-            self.sock = None
+            self.disconnect()
             raise exceptions.SocketError("Send error: {}".format(e))
 
-    def _recv(self, count, flags=0):
+    def _recv_message(self):
         try:
-            buf = []
-            l = 0
-            while l < count:
-                piece = self.sock.recv(count - l, flags)
+            while True:
+                frame = _DecodeMessage(self.buf)
+                if frame is not None:
+                    data = bytes(self.buf[frame[0]:frame[1]])
+                    del self.buf[:frame[1]]
+                    return data
+                piece = self.sock.recv(_RECV_CHUNK)
                 if len(piece) == 0:  # this means that socket is in invalid state
                     raise socket.error(socket.errno.ECONNRESET, os.strerror(socket.errno.ECONNRESET))
-                buf.append(piece)
-                l += len(piece)
-            return ''.join(buf)
+                self.buf += piece
         except socket.timeout:
+            # late response would be taken as answer to the next request
+            self.disconnect()
             raise exceptions.SocketTimeout("Got timeout: {}".format(self.socket_timeout))
-        except socket.error as e:
-            self.sock = None
+        except (socket.error, IOError) as e:
+            self.disconnect()
             raise exceptions.SocketError("Recv error: {}".format(e))
 
-    def call(self, request, timeout):
-        data = request.SerializeToString()
-        hdr = bytearray()
-        _EncodeVarint(hdr.append, len(data))
-
-        with self.lock:
-            if timeout != self.socket_timeout:
-                if self.sock is not None:
-                    self.sock.settimeout(timeout)
-                self.socket_timeout = timeout
-
+    def call(self, data, timeout):
+        self._settimeout(timeout)
+        try:
             if self.sock is None:
                 self.connect()
 
             try:
-                try:
-                    self._sendall(hdr)
-                except exceptions.SocketError:
-                    self.connect()
-                    self._sendall(hdr)
-
                 self._sendall(data)
+            except exceptions.SocketError:
+                self.connect()
+                self._sendall(data)
+
+            return self._recv_message()
+        finally:
+            self._settimeout(self.timeout)
+
+
+class _RPC(object):
+    """
+    Pool of up to pool_size connections: concurrent callers use
+    different connections instead of waiting for each other.
+    """
 
-                msb = 1
-                buf = ""
-                while msb:
-                    b = self._recv(1)
-                    msb = ord(b) >> 7
-                    buf += b
+    def __init__(self, socket_path, timeout, socket_constructor, lock_constructor, pool_size=1):
+        self.lock = lock_constructor()
+        self.idle_cond = threading.Condition(self.lock)
+        self.socket_path = socket_path
+        self.timeout = timeout
+        self.socket_constructor = socket_constructor
+        self.pool_size = max(pool_size, 1)
+        self.pool = []
+        self.idle = []
 
-                length = _DecodeVarint32(buf, 0)
-                resp = rpc_pb2.TContainerResponse()
-                buf += self._recv(length[0])
-            finally:
-                if self.socket_timeout != self.timeout:
-                    if self.sock is not None:
-                        self.sock.settimeout(self.timeout)
-                    self.socket_timeout = self.timeout
+    def _acquire(self):
+        with self.lock:
+            while not self.idle and len(self.pool) >= self.pool_size:
+                self.idle_cond.wait()
+            if self.idle:
+                return self.idle.pop()
+            conn = _Socket(self.socket_path, self.timeout, self.socket_constructor)
+            self.pool.append(conn)
+            return conn
+
+    def _release(self, conn):
+        with self.lock:
+            self.idle.append(conn)
+            self.idle_cond.notify()
 
-        resp.ParseFromString(buf[length[1]:])
+    def connect(self):
+        conn = self._acquire()
+        try:
+            conn.connect()
+        finally:
+            self._release(conn)
+
+    def disconnect(self):
+        # connections busy in other threads are left alone
+        with self.lock:
+            for conn in self.idle:
+                conn.disconnect()
+
+    def call(self, request, timeout):
+        data = _EncodeMessage(request.SerializeToString())
+
+        conn = self._acquire()
+        try:
+            data = conn.call(data, timeout)
+        finally:
+            self._release(conn)
+
+        resp = rpc_pb2.TContainerResponse()
+        resp.ParseFromString(data)
 
         if resp.error != rpc_pb2.Success:
             raise exceptions.EError.Create(resp.error, resp.errorMsg)
@@ -210,65 +312,26 @@ class _RPC(object):
         request = rpc_pb2.TContainerRequest()
         request.getProperty.name = name
         request.getProperty.property = property
-        res = self.call(request, self.timeout).getProperty.value
-        if res == 'false':
-            return False
-        elif res == 'true':
-            return True
-        return res
+        return _ParseValue(self.call(request, self.timeout).getProperty.value)
 
     def SetProperty(self, name, property, value):
-        if value is False:
-            value = 'false'
-        elif value is True:
-            value = 'true'
-        elif value is None:
-            value = ''
-        elif isinstance(value, (int, long)):
-            value = str(value)
-
         request = rpc_pb2.TContainerRequest()
         request.setProperty.name = name
         request.setProperty.property = property
-        request.setProperty.value = value
+        request.setProperty.value = _FormatValue(value)
         self.call(request, self.timeout)
 
     def GetData(self, name, data):
         request = rpc_pb2.TContainerRequest()
         request.getData.name = name
         request.getData.data = data
-        res = self.call(request, self.timeout).getData.value
-        if res == 'false':
-            return False
-        elif res == 'true':
-            return True
-        return res
+        return _ParseValue(self.call(request, self.timeout).getData.value)
 
     def Get(self, containers, variables):
         request = rpc_pb2.TContainerRequest()
         request.get.name.extend(containers)
         request.get.variable.extend(variables)
-        resp = self.call(request, self.timeout)
-        if resp.error != rpc_pb2.Success:
-            raise exceptions.EError.Create(resp.error, resp.errorMsg)
-
-        res = {}
-        for container in resp.get.list:
-            var = {}
-            for kv in container.keyval:
-                if kv.HasField('error'):
-                    var[kv.variable] = exceptions.EError.Create(kv.error, kv.errorMsg)
-                    continue
-                if kv.value == 'false':
-                    var[kv.variable] = False
-                elif kv.value == 'true':
-                    var[kv.variable] = True
-                else:
-                    var[kv.variable] = kv.value
-
-            res[container.name] = var
-
-        return res
+        return _ParseGetResponse(self.call(request, self.timeout))
 
     def ConvertPath(self, path, source, destination):
         request = rpc_pb2.TConvertPathRequest()
@@ -474,11 +537,18 @@ class Connection(object):
                  socket_path='/run/portod.socket',
                  timeout=5,
                  socket_constructor=socket.socket,
-                 lock_constructor=threading.Lock):
+                 lock_constructor=threading.Lock,
+                 pool_size=1):
+        """
+        pool_size > 1 allows that many concurrent requests from different
+        threads. Weak containers belong to the connection which created
+        them, so use them only with the default single connection.
+        """
         self.rpc = _RPC(socket_path=socket_path,
                         timeout=timeout,
                         socket_constructor=socket_constructor,
-                        lock_constructor=lock_constructor)
+                        lock_constructor=lock_constructor,
+                        pool_size=pool_size)
 
     def connect(self):
         self.rpc.connect()
@@ -11,23 +11,13 @@ class SocketTimeout(Exception):
 
 class UnknownError(Exception):
     def __str__(self):
-        return '{}: {}'.format(self.__class__.__name__, self.message)
+        return '{}: {}'.format(self.__class__.__name__, getattr(self, 'message', ' '.join(map(str, self.args))))
 
 
 class EError(Exception):
     EID = None
     __TYPES__ = {}
 
-    class __metaclass__(type):
-        def __new__(mcs, cls, bases, dct):
-            new_class = type.__new__(mcs, cls, bases, dct)
-
-            eid = dct.get('EID')
-            if eid is not None:
-                EError.__TYPES__[eid] = new_class
-
-            return new_class
-
     @classmethod
     def Create(cls, eid, msg):
         e_class = cls.__TYPES__.get(eid)
@@ -36,7 +26,7 @@ class EError(Exception):
         return UnknownError(msg)
 
     def __str__(self):
-        return '{}: {}'.format(self.__class__.__name__, self.message)
+        return '{}: {}'.format(self.__class__.__name__, getattr(self, 'message', ' '.join(map(str, self.args))))
 
 
 class InvalidMethod(EError):
@@ -109,3 +99,13 @@ class NoSpace(EError):
 
 class Busy(EError):
     EID = rpc_pb2.Busy
+
+
+class Throttled(EError):
+    EID = rpc_pb2.Throttled
+
+
+# registered explicitly: python 3 ignores __metaclass__
+for _class in list(globals().values()):
+    if isinstance(_class, type) and issubclass(_class, EError) and _class.EID is not None:
+        EError.__TYPES__[_class.EID] = _class
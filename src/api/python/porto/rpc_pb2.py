@@ -0,0 +1,131 @@
+# -*- coding: utf-8 -*-
+# Generated by the protocol buffer compiler.  DO NOT EDIT!
+# source: rpc.proto
+"""Generated protocol buffer code."""
+from google.protobuf.internal import builder as _builder
+from google.protobuf import descriptor as _descriptor
+from google.protobuf import descriptor_pool as _descriptor_pool
+from google.protobuf import symbol_database as _symbol_database
+# @@protoc_insertion_point(imports)
+
+_sym_db = _symbol_database.Default()
+
+
+
+
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\trpc.proto\x12\x03rpc\"\'\n\x17TContainerCreateRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\"(\n\x18TContainerDestroyRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\"\x17\n\x15TContainerListRequest\">\n\x1cTContainerGetPropertyRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x10\n\x08property\x18\x02 \x02(\t\"M\n\x1cTContainerSetPropertyRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x10\n\x08property\x18\x02 \x02(\t\x12\r\n\x05value\x18\x03 \x02(\t\"6\n\x18TContainerGetDataRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0c\n\x04\x64\x61ta\x18\x02 \x02(\t\"&\n\x16TContainerStartRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\"9\n\x15TContainerStopRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x12\n\ntimeout_ms\x18\x02 \x01(\r\"&\n\x16TContainerPauseRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\"\'\n\x17TContainerResumeRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\"\x1f\n\x1dTContainerPropertyListRequest\"\x1b\n\x19TContainerDataListRequest\"2\n\x15TContainerKillRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0b\n\x03sig\x18\x02 \x02(\x05\"\x11\n\x0fTVersionRequest\"H\n\x13TConvertPathRequest\x12\x0c\n\x04path\x18\x01 \x02(\t\x12\x0e\n\x06source\x18\x02 \x02(\t\x12\x13\n\x0b\x64\x65stination\x18\x03 \x02(\t\"6\n\x14TContainerGetRequest\x12\x0c\n\x04name\x18\x01 \x03(\t\x12\x10\n\x08variable\x18\x02 \x03(\t\"6\n\x15TContainerWaitRequest\x12\x0c\n\x04name\x18\x01 \x03(\t\x12\x0f\n\x07timeout\x18\x02 \x01(\r\"1\n\x12TContainerProperty\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\r\n\x05value\x18\x02 \x02(\t\"r\n\x15TContainerSpecRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12+\n\nproperties\x18\x02 \x03(\x0b\x32\x17.rpc.TContainerProperty\x12\x0f\n\x07volumes\x18\x03 \x03(\t\x12\r\n\x05start\x18\x04 \x01(\x08\"9\n\x1bTContainerCheckpointRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0c\n\x04path\x18\x02 \x02(\t\"6\n\x18TContainerRestoreRequest\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0c\n\x04path\x18\x02 \x02(\t\"\xd3\x0b\n\x11TContainerRequest\x12,\n\x06\x63reate\x18\x01 \x01(\x0b\x32\x1c.rpc.TContainerCreateRequest\x12.\n\x07\x64\x65stroy\x18\x02 \x01(\x0b\x32\x1d.rpc.TContainerDestroyRequest\x12(\n\x04list\x18\x03 \x01(\x0b\x32\x1a.rpc.TContainerListRequest\x12\x36\n\x0bgetProperty\x18\x04 \x01(\x0b\x32!.rpc.TContainerGetPropertyRequest\x12\x36\n\x0bsetProperty\x18\x05 \x01(\x0b\x32!.rpc.TContainerSetPropertyRequest\x12.\n\x07getData\x18\x06 \x01(\x0b\x32\x1d.rpc.TContainerGetDataRequest\x12*\n\x05start\x18\x07 \x01(\x0b\x32\x1b.rpc.TContainerStartRequest\x12(\n\x04stop\x18\x08 \x01(\x0b\x32\x1a.rpc.TContainerStopRequest\x12*\n\x05pause\x18\t \x01(\x0b\x32\x1b.rpc.TContainerPauseRequest\x12,\n\x06resume\x18\n \x01(\x0b\x32\x1c.rpc.TContainerResumeRequest\x12\x38\n\x0cpropertyList\x18\x0b \x01(\x0b\x32\".rpc.TContainerPropertyListRequest\x12\x30\n\x08\x64\x61taList\x18\x0c \x01(\x0b\x32\x1e.rpc.TContainerDataListRequest\x12(\n\x04kill\x18\r \x01(\x0b\x32\x1a.rpc.TContainerKillRequest\x12%\n\x07version\x18\x0e \x01(\x0b\x32\x14.rpc.TVersionRequest\x12&\n\x03get\x18\x0f \x01(\x0b\x32\x19.rpc.TContainerGetRequest\x12(\n\x04wait\x18\x10 \x01(\x0b\x32\x1a.rpc.TContainerWaitRequest\x12\x30\n\ncreateWeak\x18\x11 \x01(\x0b\x32\x1c.rpc.TContainerCreateRequest\x12-\n\tapplySpec\x18\x12 \x01(\x0b\x32\x1a.rpc.TContainerSpecRequest\x12\x34\n\ncheckpoint\x18\x13 \x01(\x0b\x32 .rpc.TContainerCheckpointRequest\x12.\n\x07restore\x18\x14 \x01(\x0b\x32\x1d.rpc.TContainerRestoreRequest\x12=\n\x14listVolumeProperties\x18g \x01(\x0b\x32\x1f.rpc.TVolumePropertyListRequest\x12/\n\x0c\x63reateVolume\x18h \x01(\x0b\x32\x19.rpc.TVolumeCreateRequest\x12+\n\nlinkVolume\x18i \x01(\x0b\x32\x17.rpc.TVolumeLinkRequest\x12/\n\x0cunlinkVolume\x18j \x01(\x0b\x32\x19.rpc.TVolumeUnlinkRequest\x12,\n\x0blistVolumes\x18k \x01(\x0b\x32\x17.rpc.TVolumeListRequest\x12+\n\ntuneVolume\x18l \x01(\x0b\x32\x17.rpc.TVolumeTuneRequest\x12-\n\x0bimportLayer\x18n \x01(\x0b\x32\x18.rpc.TLayerImportRequest\x12-\n\x0bremoveLayer\x18o \x01(\x0b\x32\x18.rpc.TLayerRemoveRequest\x12*\n\nlistLayers\x18p \x01(\x0b\x32\x16.rpc.TLayerListRequest\x12-\n\x0b\x65xportLayer\x18q \x01(\x0b\x32\x18.rpc.TLayerExportRequest\x12.\n\x0b\x63onvertPath\x18\xc8\x01 \x01(\x0b\x32\x18.rpc.TConvertPathRequest\"&\n\x16TContainerListResponse\x12\x0c\n\x04name\x18\x01 \x03(\t\".\n\x1dTContainerGetPropertyResponse\x12\r\n\x05value\x18\x01 \x02(\t\"*\n\x19TContainerGetDataResponse\x12\r\n\x05value\x18\x01 \x02(\t\"\xaa\x01\n\x1eTContainerPropertyListResponse\x12M\n\x04list\x18\x01 \x03(\x0b\x32?.rpc.TContainerPropertyListResponse.TContainerPropertyListEntry\x1a\x39\n\x1bTContainerPropertyListEntry\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0c\n\x04\x64\x65sc\x18\x02 \x02(\t\"\x9a\x01\n\x1aTContainerDataListResponse\x12\x45\n\x04list\x18\x01 \x03(\x0b\x32\x37.rpc.TContainerDataListResponse.TContainerDataListEntry\x1a\x35\n\x17TContainerDataListEntry\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0c\n\x04\x64\x65sc\x18\x02 \x02(\t\"1\n\x10TVersionResponse\x12\x0b\n\x03tag\x18\x01 \x02(\t\x12\x10\n\x08revision\x18\x02 \x02(\t\"\xba\x02\n\x15TContainerGetResponse\x12\x42\n\x04list\x18\x01 \x03(\x0b\x32\x34.rpc.TContainerGetResponse.TContainerGetListResponse\x1ak\n\x1aTContainerGetValueResponse\x12\x10\n\x08variable\x18\x01 \x02(\t\x12\x1a\n\x05\x65rror\x18\x02 \x01(\x0e\x32\x0b.rpc.EError\x12\x10\n\x08\x65rrorMsg\x18\x03 \x01(\t\x12\r\n\x05value\x18\x04 \x01(\t\x1ap\n\x19TContainerGetListResponse\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x45\n\x06keyval\x18\x02 \x03(\x0b\x32\x35.rpc.TContainerGetResponse.TContainerGetValueResponse\"&\n\x16TContainerWaitResponse\x12\x0c\n\x04name\x18\x01 \x02(\t\"$\n\x14TConvertPathResponse\x12\x0c\n\x04path\x18\x01 \x02(\t\"0\n\x0fTContainerPhase\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0f\n\x07time_ms\x18\x02 \x02(\x04\"\xd5\x05\n\x12TContainerResponse\x12\x1a\n\x05\x65rror\x18\x01 \x02(\x0e\x32\x0b.rpc.EError\x12\x10\n\x08\x65rrorMsg\x18\x02 \x01(\t\x12)\n\x04list\x18\x03 \x01(\x0b\x32\x1b.rpc.TContainerListResponse\x12\x37\n\x0bgetProperty\x18\x04 \x01(\x0b\x32\".rpc.TContainerGetPropertyResponse\x12/\n\x07getData\x18\x05 \x01(\x0b\x32\x1e.rpc.TContainerGetDataResponse\x12\x39\n\x0cpropertyList\x18\x06 \x01(\x0b\x32#.rpc.TContainerPropertyListResponse\x12\x31\n\x08\x64\x61taList\x18\x07 \x01(\x0b\x32\x1f.rpc.TContainerDataListResponse\x12&\n\x07version\x18\x08 \x01(\x0b\x32\x15.rpc.TVersionResponse\x12,\n\nvolumeList\x18\t \x01(\x0b\x32\x18.rpc.TVolumeListResponse\x12\'\n\x03get\x18\n \x01(\x0b\x32\x1a.rpc.TContainerGetResponse\x12)\n\x04wait\x18\x0b \x01(\x0b\x32\x1b.rpc.TContainerWaitResponse\x12<\n\x12volumePropertyList\x18\x0c \x01(\x0b\x32 .rpc.TVolumePropertyListResponse\x12\'\n\x06volume\x18\r \x01(\x0b\x32\x17.rpc.TVolumeDescription\x12\'\n\x06layers\x18\x0e \x01(\x0b\x32\x17.rpc.TLayerListResponse\x12.\n\x0b\x63onvertPath\x18\x0f \x01(\x0b\x32\x19.rpc.TConvertPathResponse\x12$\n\x06phases\x18\x10 \x03(\x0b\x32\x14.rpc.TContainerPhase\".\n\x0fTVolumeProperty\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\r\n\x05value\x18\x02 \x02(\t\"8\n\x1aTVolumePropertyDescription\x12\x0c\n\x04name\x18\x01 \x02(\t\x12\x0c\n\x04\x64\x65sc\x18\x02 \x02(\t\"`\n\x12TVolumeDescription\x12\x0c\n\x04path\x18\x01 \x02(\t\x12(\n\nproperties\x18\x02 \x03(\x0b\x32\x14.rpc.TVolumeProperty\x12\x12\n\ncontainers\x18\x03 \x03(\t\"\x1c\n\x1aTVolumePropertyListRequest\"R\n\x1bTVolumePropertyListResponse\x12\x33\n\nproperties\x18\x01 \x03(\x0b\x32\x1f.rpc.TVolumePropertyDescription\"N\n\x14TVolumeCreateRequest\x12\x0c\n\x04path\x18\x01 \x01(\t\x12(\n\nproperties\x18\x02 \x03(\x0b\x32\x14.rpc.TVolumeProperty\"5\n\x12TVolumeLinkRequest\x12\x0c\n\x04path\x18\x01 \x02(\t\x12\x11\n\tcontainer\x18\x02 \x01(\t\"7\n\x14TVolumeUnlinkRequest\x12\x0c\n\x04path\x18\x01 \x02(\t\x12\x11\n\tcontainer\x18\x02 \x01(\t\"5\n\x12TVolumeListRequest\x12\x0c\n\x04path\x18\x01 \x01(\t\x12\x11\n\tcontainer\x18\x02 \x01(\t\"L\n\x12TVolumeTuneRequest\x12\x0c\n\x04path\x18\x01 \x02(\t\x12(\n\nproperties\x18\x02 \x03(\x0b\x32\x14.rpc.TVolumeProperty\"?\n\x13TVolumeListResponse\x12(\n\x07volumes\x18\x01 \x03(\x0b\x32\x17.rpc.TVolumeDescription\"D\n\x13TLayerImportRequest\x12\r\n\x05layer\x18\x01 \x02(\t\x12\x0f\n\x07tarball\x18\x02 \x02(\t\x12\r\n\x05merge\x18\x03 \x02(\x08\"6\n\x13TLayerExportRequest\x12\x0e\n\x06volume\x18\x01 \x02(\t\x12\x0f\n\x07tarball\x18\x02 \x02(\t\"$\n\x13TLayerRemoveRequest\x12\r\n\x05layer\x18\x01 \x02(\t\"\x13\n\x11TLayerListRequest\"#\n\x12TLayerListResponse\x12\r\n\x05layer\x18\x01 \x03(\t*\xab\x03\n\x06\x45\x45rror\x12\x0b\n\x07Success\x10\x00\x12\x0b\n\x07Unknown\x10\x01\x12\x11\n\rInvalidMethod\x10\x02\x12\x1a\n\x16\x43ontainerAlreadyExists\x10\x03\x12\x19\n\x15\x43ontainerDoesNotExist\x10\x04\x12\x13\n\x0fInvalidProperty\x10\x05\x12\x0f\n\x0bInvalidData\x10\x06\x12\x10\n\x0cInvalidValue\x10\x07\x12\x10\n\x0cInvalidState\x10\x08\x12\x10\n\x0cNotSupported\x10\t\x12\x18\n\x14ResourceNotAvailable\x10\n\x12\x0e\n\nPermission\x10\x0b\x12\x17\n\x13VolumeAlreadyExists\x10\x0c\x12\x12\n\x0eVolumeNotFound\x10\r\x12\x0b\n\x07NoSpace\x10\x0e\x12\x08\n\x04\x42usy\x10\x0f\x12\x17\n\x13VolumeAlreadyLinked\x10\x10\x12\x13\n\x0fVolumeNotLinked\x10\x11\x12\x16\n\x12LayerAlreadyExists\x10\x12\x12\x11\n\rLayerNotFound\x10\x13\x12\r\n\tThrottled\x10\x14\x12\x0b\n\x06Queued\x10\xe8\x07')
+
+_builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, globals())
+_builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'rpc_pb2', globals())
+if _descriptor._USE_C_DESCRIPTORS == False:
+
+  DESCRIPTOR._options = None
+  _EERROR._serialized_start=5217
+  _EERROR._serialized_end=5644
+  _TCONTAINERCREATEREQUEST._serialized_start=18
+  _TCONTAINERCREATEREQUEST._serialized_end=57
+  _TCONTAINERDESTROYREQUEST._serialized_start=59
+  _TCONTAINERDESTROYREQUEST._serialized_end=99
+  _TCONTAINERLISTREQUEST._serialized_start=101
+  _TCONTAINERLISTREQUEST._serialized_end=124
+  _TCONTAINERGETPROPERTYREQUEST._serialized_start=126
+  _TCONTAINERGETPROPERTYREQUEST._serialized_end=188
+  _TCONTAINERSETPROPERTYREQUEST._serialized_start=190
+  _TCONTAINERSETPROPERTYREQUEST._serialized_end=267
+  _TCONTAINERGETDATAREQUEST._serialized_start=269
+  _TCONTAINERGETDATAREQUEST._serialized_end=323
+  _TCONTAINERSTARTREQUEST._serialized_start=325
+  _TCONTAINERSTARTREQUEST._serialized_end=363
+  _TCONTAINERSTOPREQUEST._serialized_start=365
+  _TCONTAINERSTOPREQUEST._serialized_end=422
+  _TCONTAINERPAUSEREQUEST._serialized_start=424
+  _TCONTAINERPAUSEREQUEST._serialized_end=462
+  _TCONTAINERRESUMEREQUEST._serialized_start=464
+  _TCONTAINERRESUMEREQUEST._serialized_end=503
+  _TCONTAINERPROPERTYLISTREQUEST._serialized_start=505
+  _TCONTAINERPROPERTYLISTREQUEST._serialized_end=536
+  _TCONTAINERDATALISTREQUEST._serialized_start=538
+  _TCONTAINERDATALISTREQUEST._serialized_end=565
+  _TCONTAINERKILLREQUEST._serialized_start=567
+  _TCONTAINERKILLREQUEST._serialized_end=617
+  _TVERSIONREQUEST._serialized_start=619
+  _TVERSIONREQUEST._serialized_end=636
+  _TCONVERTPATHREQUEST._serialized_start=638
+  _TCONVERTPATHREQUEST._serialized_end=710
+  _TCONTAINERGETREQUEST._serialized_start=712
+  _TCONTAINERGETREQUEST._serialized_end=766
+  _TCONTAINERWAITREQUEST._serialized_start=768
+  _TCONTAINERWAITREQUEST._serialized_end=822
+  _TCONTAINERPROPERTY._serialized_start=824
+  _TCONTAINERPROPERTY._serialized_end=873
+  _TCONTAINERSPECREQUEST._serialized_start=875
+  _TCONTAINERSPECREQUEST._serialized_end=989
+  _TCONTAINERCHECKPOINTREQUEST._serialized_start=991
+  _TCONTAINERCHECKPOINTREQUEST._serialized_end=1048
+  _TCONTAINERRESTOREREQUEST._serialized_start=1050
+  _TCONTAINERRESTOREREQUEST._serialized_end=1104
+  _TCONTAINERREQUEST._serialized_start=1107
+  _TCONTAINERREQUEST._serialized_end=2598
+  _TCONTAINERLISTRESPONSE._serialized_start=2600
+  _TCONTAINERLISTRESPONSE._serialized_end=2638
+  _TCONTAINERGETPROPERTYRESPONSE._serialized_start=2640
+  _TCONTAINERGETPROPERTYRESPONSE._serialized_end=2686
+  _TCONTAINERGETDATARESPONSE._serialized_start=2688
+  _TCONTAINERGETDATARESPONSE._serialized_end=2730
+  _TCONTAINERPROPERTYLISTRESPONSE._serialized_start=2733
+  _TCONTAINERPROPERTYLISTRESPONSE._serialized_end=2903
+  _TCONTAINERPROPERTYLISTRESPONSE_TCONTAINERPROPERTYLISTENTRY._serialized_start=2846
+  _TCONTAINERPROPERTYLISTRESPONSE_TCONTAINERPROPERTYLISTENTRY._serialized_end=2903
+  _TCONTAINERDATALISTRESPONSE._serialized_start=2906
+  _TCONTAINERDATALISTRESPONSE._serialized_end=3060
+  _TCONTAINERDATALISTRESPONSE_TCONTAINERDATALISTENTRY._serialized_start=3007
+  _TCONTAINERDATALISTRESPONSE_TCONTAINERDATALISTENTRY._serialized_end=3060
+  _TVERSIONRESPONSE._serialized_start=3062
+  _TVERSIONRESPONSE._serialized_end=3111
+  _TCONTAINERGETRESPONSE._serialized_start=3114
+  _TCONTAINERGETRESPONSE._serialized_end=3428
+  _TCONTAINERGETRESPONSE_TCONTAINERGETVALUERESPONSE._serialized_start=3207
+  _TCONTAINERGETRESPONSE_TCONTAINERGETVALUERESPONSE._serialized_end=3314
+  _TCONTAINERGETRESPONSE_TCONTAINERGETLISTRESPONSE._serialized_start=3316
+  _TCONTAINERGETRESPONSE_TCONTAINERGETLISTRESPONSE._serialized_end=3428
+  _TCONTAINERWAITRESPONSE._serialized_start=3430
+  _TCONTAINERWAITRESPONSE._serialized_end=3468
+  _TCONVERTPATHRESPONSE._serialized_start=3470
+  _TCONVERTPATHRESPONSE._serialized_end=3506
+  _TCONTAINERPHASE._serialized_start=3508
+  _TCONTAINERPHASE._serialized_end=3556
+  _TCONTAINERRESPONSE._serialized_start=3559
+  _TCONTAINERRESPONSE._serialized_end=4284
+  _TVOLUMEPROPERTY._serialized_start=4286
+  _TVOLUMEPROPERTY._serialized_end=4332
+  _TVOLUMEPROPERTYDESCRIPTION._serialized_start=4334
+  _TVOLUMEPROPERTYDESCRIPTION._serialized_end=4390
+  _TVOLUMEDESCRIPTION._serialized_start=4392
+  _TVOLUMEDESCRIPTION._serialized_end=4488
+  _TVOLUMEPROPERTYLISTREQUEST._serialized_start=4490
+  _TVOLUMEPROPERTYLISTREQUEST._serialized_end=4518
+  _TVOLUMEPROPERTYLISTRESPONSE._serialized_start=4520
+  _TVOLUMEPROPERTYLISTRESPONSE._serialized_end=4602
+  _TVOLUMECREATEREQUEST._serialized_start=4604
+  _TVOLUMECREATEREQUEST._serialized_end=4682
+  _TVOLUMELINKREQUEST._serialized_start=4684
+  _TVOLUMELINKREQUEST._serialized_end=4737
+  _TVOLUMEUNLINKREQUEST._serialized_start=4739
+  _TVOLUMEUNLINKREQUEST._serialized_end=4794
+  _TVOLUMELISTREQUEST._serialized_start=4796
+  _TVOLUMELISTREQUEST._serialized_end=4849
+  _TVOLUMETUNEREQUEST._serialized_start=4851
+  _TVOLUMETUNEREQUEST._serialized_end=4927
+  _TVOLUMELISTRESPONSE._serialized_start=4929
+  _TVOLUMELISTRESPONSE._serialized_end=4992
+  _TLAYERIMPORTREQUEST._serialized_start=4994
+  _TLAYERIMPORTREQUEST._serialized_end=5062
+  _TLAYEREXPORTREQUEST._serialized_start=5064
+  _TLAYEREXPORTREQUEST._serialized_end=5118
+  _TLAYERREMOVEREQUEST._serialized_start=5120
+  _TLAYERREMOVEREQUEST._serialized_end=5156
+  _TLAYERLISTREQUEST._serialized_start=5158
+  _TLAYERLISTREQUEST._serialized_end=5177
+  _TLAYERLISTRESPONSE._serialized_start=5179
+  _TLAYERLISTRESPONSE._serialized_end=5214
+# @@protoc_insertion_point(module_scope)
@@ -1,4 +1,14 @@
+import sys
 from setuptools import setup
+from setuptools.command.build_py import build_py
+
+class BuildPy(build_py):
+    def find_package_modules(self, package, package_dir):
+        modules = build_py.find_package_modules(self, package, package_dir)
+        if sys.version_info < (3, 5):
+            # async syntax breaks byte compilation by python2
+            modules = [m for m in modules if m[1] != 'aio']
+        return modules
 
 def readme():
     with open('README.rst') as f:
@@ -16,5 +26,6 @@ setup(name='portopy',
     install_requires=[
         'protobuf',
     ],
+    cmdclass={'build_py': BuildPy},
     zip_safe=False)
 
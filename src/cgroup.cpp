@@ -1,10 +1,12 @@
 #include <algorithm>
 #include <cmath>
 #include <csignal>
+#include <map>
 
 #include "cgroup.hpp"
 #include "device.hpp"
 #include "config.hpp"
+#include "statistics.hpp"
 #include "util/log.hpp"
 #include "util/string.hpp"
 #include "util/unix.hpp"
@@ -14,6 +16,8 @@ extern "C" {
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/bpf.h>
 }
 
 TPath TCgroup::Path() const {
@@ -28,6 +32,123 @@ TPath TCgroup::Knob(const std::string &knob) const {
     return Subsystem->Root / Name / knob;
 }
 
+/* cgroup v2: controllers must be enabled in parent to appear in children */
+static void EnableControllers(const TCgroup &cg) {
+    std::vector<std::string> available, enabled;
+    std::string value, change;
+
+    if (cg.Get("cgroup.controllers", value) ||
+            SplitString(StringTrim(value), ' ', available))
+        return;
+
+    if (cg.Get("cgroup.subtree_control", value) ||
+            SplitString(StringTrim(value), ' ', enabled))
+        return;
+
+    for (auto ctrl: { "cpu", "io", "memory", "pids" }) {
+        if (std::find(available.begin(), available.end(), ctrl) != available.end() &&
+                std::find(enabled.begin(), enabled.end(), ctrl) == enabled.end())
+            change += std::string(change.empty() ? "+" : " +") + ctrl;
+    }
+
+    if (change.empty())
+        return;
+
+    /* fails with EBUSY if cgroup has own processes */
+    TError error = cg.Set("cgroup.subtree_control", change);
+    if (error)
+        L_WRN() << "Cannot enable controllers for childs of " << cg << " : " << error << std::endl;
+}
+
+/* Knobs and initial values of simulated cgroups */
+static const std::map<std::string, std::vector<std::pair<std::string, std::string>>> SimulatedKnobs = {
+    { "memory", {
+        { "memory.usage_in_bytes", "0" },
+        { "memory.max_usage_in_bytes", "0" },
+        { "memory.limit_in_bytes", "9223372036854771712" },
+        { "memory.memsw.limit_in_bytes", "9223372036854771712" },
+        { "memory.soft_limit_in_bytes", "9223372036854771712" },
+        { "memory.low_limit_in_bytes", "0" },
+        { "memory.use_hierarchy", "1" },
+        { "memory.failcnt", "0" },
+        { "memory.high_limit_in_bytes", "9223372036854771712" },
+        { "memory.oom_control", "oom_kill_disable 0\nunder_oom 0\n" },
+        { "memory.stat", "cache 0\nrss 0\nmapped_file 0\ntotal_cache 0\ntotal_rss 0\n" },
+        { "cgroup.event_control", "" },
+    } },
+    { "freezer", {
+        { "freezer.state", "THAWED" },
+    } },
+    { "cpu", {
+        { "cpu.shares", "1024" },
+        { "cpu.cfs_quota_us", "-1" },
+        { "cpu.cfs_period_us", "100000" },
+        { "cpu.stat", "nr_periods 0\nnr_throttled 0\nthrottled_time 0\n" },
+    } },
+    { "cpuacct", {
+        { "cpuacct.usage", "0" },
+        { "cpuacct.stat", "user 0\nsystem 0\n" },
+        { "cpuacct.wait", "0" },
+    } },
+    { "net_cls", {
+        { "net_cls.classid", "0" },
+    } },
+    { "blkio", {
+        { "blkio.weight", "500" },
+        { "blkio.weight_device", "" },
+        { "blkio.io_service_bytes_recursive", "Total 0\n" },
+        { "blkio.io_serviced_recursive", "Total 0\n" },
+        { "blkio.io_service_time_recursive", "Total 0\n" },
+        { "blkio.io_wait_time_recursive", "Total 0\n" },
+        { "blkio.io_queued_recursive", "Total 0\n" },
+    } },
+    { "devices", {
+        { "devices.allow", "" },
+        { "devices.deny", "" },
+        { "devices.list", "a *:* rwm\n" },
+    } },
+    { "pids", {
+        { "pids.max", "max" },
+        { "pids.current", "0" },
+        { "pids.events", "max 0\n" },
+    } },
+};
+
+static TError SimulateKnobs(const TCgroup &cg) {
+    std::vector<std::pair<std::string, std::string>> knobs = {
+        { "cgroup.procs", "" },
+        { "tasks", "" },
+    };
+    auto it = SimulatedKnobs.find(cg.Type());
+    if (it != SimulatedKnobs.end())
+        knobs.insert(knobs.end(), it->second.begin(), it->second.end());
+
+    for (auto &knob: knobs) {
+        TPath path = cg.Knob(knob.first);
+        if (path.Exists())
+            continue;
+        TError error = path.Mkfile(0644);
+        if (!error)
+            error = path.WriteAll(knob.second);
+        if (error)
+            return error;
+    }
+
+    return TError::Success();
+}
+
+/* Kernel removes exited tasks and zombies from cgroups */
+static bool SimulatedTaskAlive(pid_t pid) {
+    std::string stat;
+
+    if (TPath("/proc/" + std::to_string(pid) + "/stat").ReadAll(stat))
+        return false;
+
+    auto pos = stat.rfind(')');
+    return pos != std::string::npos && pos + 2 < stat.size() &&
+           stat[pos + 2] != 'Z' && stat[pos + 2] != 'X';
+}
+
 bool TCgroup::IsRoot() const {
     return Name == "/";
 }
@@ -45,13 +166,35 @@ TError TCgroup::Create() const {
         return TError(EError::Unknown, "Cannot create secondary cgroup " + Type());
 
     L_ACT() << "Create cgroup " << *this << std::endl;
+    if (Subsystem->Unified)
+        EnableControllers(Parent());
     error = Path().Mkdir(0755);
+    if (!error && Subsystem->Simulated)
+        error = SimulateKnobs(*this);
     if (error)
         L_ERR() << "Cannot create cgroup " << *this << " : " << error << std::endl;
 
     return error;
 }
 
+TError TCgroup::RemoveDir() const {
+    if (Subsystem->Simulated) {
+        std::vector<std::string> subdirs;
+        std::vector<pid_t> tasks;
+
+        /* kernel refuses to remove populated cgroups */
+        TError error = Path().ListSubdirs(subdirs);
+        if (!error && (!subdirs.empty() || (!GetTasks(tasks) && !tasks.empty())))
+            error = TError(EError::Unknown, EBUSY, "Cgroup is busy");
+        if (!error)
+            error = Path().ClearDirectory();
+        if (error)
+            return error;
+    }
+
+    return Path().Rmdir();
+}
+
 TError TCgroup::Remove() const {
     struct stat st;
     TError error;
@@ -60,14 +203,15 @@ TError TCgroup::Remove() const {
         return TError(EError::Unknown, "Cannot create secondary cgroup " + Type());
 
     L_ACT() << "Remove cgroup " << *this << std::endl;
-    error = Path().Rmdir();
+
+    error = RemoveDir();
 
     /* workaround for bad synchronization */
     if (error && error.GetErrno() == EBUSY &&
             !Path().StatStrict(st) && st.st_nlink == 2) {
         for (int i = 0; i < 100; i++) {
             usleep(config().daemon().cgroup_remove_timeout_s() * 10000);
-            error = Path().Rmdir();
+            error = RemoveDir();
             if (!error || error.GetErrno() != EBUSY)
                 break;
         }
@@ -91,11 +235,85 @@ TError TCgroup::Get(const std::string &knob, std::string &value) const {
     return Knob(knob).ReadAll(value);
 }
 
+/* cgroup v2 knob value equal to kernel default, i.e. enforces nothing */
+static bool UnifiedDefault(const std::string &knob, const std::string &value) {
+    if (value == "0" || value == "max" || StringStartsWith(value, "max "))
+        return true;
+    if (knob == "cpu.weight")
+        return value == "100";
+    if (knob == "io.weight")
+        return value == "default 100";
+    if (knob == "io.max") {
+        for (auto pos = value.find('='); pos != std::string::npos;
+                pos = value.find('=', pos + 1))
+            if (value.compare(pos + 1, 3, "max"))
+                return false;
+        return true;
+    }
+    return false;
+}
+
 TError TCgroup::Set(const std::string &knob, const std::string &value) const {
     if (!Subsystem)
         return TError(EError::Unknown, "Cannot set to null cgroup");
+    if (Subsystem->Unified && !Knob(knob).Exists()) {
+        /* controller isn't enabled here: parent has own processes */
+        if (UnifiedDefault(knob, value))
+            return TError::Success();
+        return TError(EError::NotSupported, "Cannot set " + knob + " = " + value +
+                      " in " + Name + ": controller is not enabled, parent has own processes");
+    }
+
+    TPath path = Knob(knob);
+
+    if (Applied) {
+        auto it = Applied->Values.find(path.ToString());
+        if (it != Applied->Values.end() && it->second == value) {
+            Statistics->CgroupWritesSkipped++;
+            return TError::Success();
+        }
+    }
+
     L_ACT() << "Set " << *this << " " << knob << " = " << value << std::endl;
-    return Knob(knob).WriteAll(value);
+    TError error = path.WriteAll(value);
+
+    if (Applied) {
+        if (error)
+            Applied->Values.erase(path.ToString());
+        else
+            Applied->Values[path.ToString()] = value;
+    }
+
+    return error;
+}
+
+TError TCgroup::SetLines(const std::string &knob,
+                         const std::vector<std::string> &lines) const {
+    TError error;
+
+    if (!Subsystem)
+        return TError(EError::Unknown, "Cannot set to null cgroup");
+    if (lines.empty())
+        return TError::Success();
+
+    TPath path = Knob(knob);
+    int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC | O_TRUNC);
+    if (fd < 0)
+        return TError(EError::Unknown, errno, "Cannot open for write: " + path.ToString());
+
+    /* kernel parses one value per write */
+    for (auto &line: lines) {
+        L_ACT() << "Set " << *this << " " << knob << " = " << line << std::endl;
+        if (write(fd, line.c_str(), line.size()) != (ssize_t)line.size()) {
+            error = TError(EError::Unknown, errno, "write(" + path.ToString() + ")");
+            break;
+        }
+    }
+
+    if (close(fd) < 0 && !error)
+        error = TError(EError::Unknown, errno, "close(" + path.ToString() + ")");
+
+    return error;
 }
 
 TError TCgroup::GetUint64(const std::string &knob, uint64_t &value) const {
@@ -147,13 +365,36 @@ TError TCgroup::Attach(pid_t pid) const {
         return TError(EError::Unknown, "Cannot attach to secondary cgroup " + Type());
 
     L_ACT() << "Attach process " << pid << " to " << *this << std::endl;
-    TError error = Knob("cgroup.procs").WriteAll(std::to_string(pid));
+
+    TError error;
+    if (Subsystem->Simulated) {
+        std::vector<pid_t> tasks;
+        std::string list;
+
+        /* forget dead processes, moving from other cgroups isn't tracked */
+        error = GetTasks(tasks);
+        tasks.push_back(pid);
+        for (auto task: tasks)
+            list += std::to_string(task) + "\n";
+        if (!error)
+            error = Knob("tasks").WriteAll(list);
+        if (!error)
+            error = Knob("cgroup.procs").WriteAll(list);
+    } else
+        error = Knob("cgroup.procs").WriteAll(std::to_string(pid));
     if (error)
         L_ERR() << "Cannot attach process " << pid << " to " << *this << " : " << error << std::endl;
 
     return error;
 }
 
+TCgroup TCgroup::Parent() const {
+    if (IsRoot())
+        return *this;
+    auto pos = Name.rfind('/');
+    return TCgroup(Subsystem, pos ? Name.substr(0, pos) : "/");
+}
+
 TCgroup TCgroup::Child(const std::string& name) const {
     PORTO_ASSERT(name[0] != '/');
     if (IsRoot())
@@ -199,6 +440,26 @@ TError TCgroup::ChildsAll(std::vector<TCgroup> &cgroups) const {
     return error;
 }
 
+/* Kills and removes cgroup with all childs, for leftovers */
+TError TCgroup::RemoveSubtree() const {
+    std::vector<TCgroup> cgroups;
+    TError error;
+
+    (void)ChildsAll(cgroups);
+    cgroups.insert(cgroups.begin(), *this);
+    for (auto &cg: cgroups)
+        if (!cg.IsEmpty())
+            (void)cg.KillAll(9);
+
+    for (auto cg = cgroups.rbegin(); cg != cgroups.rend(); cg++) {
+        TError error2 = cg->Remove();
+        if (error2 && !error)
+            error = error2;
+    }
+
+    return error;
+}
+
 TError TCgroup::GetPids(const std::string &knob, std::vector<pid_t> &pids) const {
     FILE *file;
     int pid;
@@ -209,8 +470,12 @@ TError TCgroup::GetPids(const std::string &knob, std::vector<pid_t> &pids) const
     file = fopen(Knob(knob).c_str(), "r");;
     if (!file)
         return TError(EError::Unknown, errno, "Cannot open knob " + knob);
-    while (fscanf(file, "%d", &pid) == 1)
+    while (fscanf(file, "%d", &pid) == 1) {
+        /* simulated cgroups keep exited processes */
+        if (Subsystem->Simulated && !SimulatedTaskAlive(pid))
+            continue;
         pids.push_back(pid);
+    }
     fclose(file);
 
     return TError::Success();
@@ -219,6 +484,12 @@ TError TCgroup::GetPids(const std::string &knob, std::vector<pid_t> &pids) const
 bool TCgroup::IsEmpty() const {
     std::vector<pid_t> tasks;
 
+    if (Subsystem && Subsystem->Unified) {
+        TUintMap events;
+        if (!GetUintMap("cgroup.events", events))
+            return !events["populated"];
+    }
+
     GetTasks(tasks);
     return tasks.empty();
 }
@@ -229,6 +500,10 @@ TError TCgroup::KillAll(int signal) const {
 
     L_ACT() << "KillAll " << signal << " " << *this << std::endl;
 
+    /* kills whole subtree without races with fork */
+    if (signal == SIGKILL && Subsystem && Subsystem->Unified && Has("cgroup.kill"))
+        return SetBool("cgroup.kill", true);
+
     error = GetTasks(tasks);
     if (!error) {
         for (const auto &pid : tasks) {
@@ -253,13 +528,20 @@ TCgroup TSubsystem::Cgroup(const std::string &name) const {
 }
 
 TError TSubsystem::TaskCgroup(pid_t pid, TCgroup &cgroup) const {
+    /* processes are not moved into simulated cgroups */
+    if (Simulated) {
+        cgroup = RootCgroup();
+        return TError::Success();
+    }
+
     FILE *file = fopen(("/proc/" + std::to_string(pid) + "/cgroup").c_str(), "r");
 
     if (file) {
         int id;
 
         while (fscanf(file, "%d:", &id) == 1) {
-            bool found = false;
+            /* cgroup v2 is listed as "0::/path" */
+            bool found = Unified && id == 0;
             char *ss, *cg;
 
             while (fscanf(file, "%m[^:,],", &ss) == 1) {
@@ -286,11 +568,135 @@ TError TSubsystem::TaskCgroup(pid_t pid, TCgroup &cgroup) const {
                     " cgroup for process " + std::to_string(pid));
 }
 
+/* Total stall time from "some" line of psi knob, ns */
+static TError GetPressureTotal(TCgroup &cg, const std::string &knob, uint64_t &value) {
+    std::vector<std::string> lines;
+    std::string text;
+    uint64_t usec;
+
+    TError error = cg.Get(knob, text);
+    if (error)
+        return error;
+
+    (void)SplitString(text, '\n', lines);
+    for (auto &line: lines) {
+        auto pos = line.find("total=");
+        if (!StringStartsWith(line, "some ") || pos == std::string::npos)
+            continue;
+        error = StringToUint64(StringTrim(line.substr(pos + 6)), usec);
+        if (!error)
+            value = usec * 1000;
+        return error;
+    }
+
+    return TError(EError::Unknown, "Cannot parse " + knob);
+}
+
 // Memory
+TError TMemorySubsystem::Statistics(TCgroup &cg, TUintMap &stat) const {
+    TError error = cg.GetUintMap(STAT, stat);
+    if (error || !Unified)
+        return error;
+
+    /* cgroup v2 statistics are hierarchical, provide v1 names for them */
+    TUintMap total;
+    for (auto &it: stat)
+        total["total_" + it.first] = it.second;
+    stat.insert(total.begin(), total.end());
+
+    uint64_t peak;
+    if (cg.Has(PEAK) && !cg.GetUint64(PEAK, peak))
+        stat["total_max_rss"] = peak;
+
+    return error;
+}
+
+/*
+ * Typed subset of memory.stat under stable names. Fields missing in this
+ * kernel are omitted. Statistics of cgroup v2 are always hierarchical.
+ */
+TError TMemorySubsystem::GetMemoryStat(TCgroup &cg, bool hierarchical, TUintMap &stat) const {
+    static const std::vector<std::pair<std::string, std::string>> legacy = {
+        { "cache", "cache" },
+        { "rss", "rss" },
+        { "mapped", "mapped_file" },
+        { "dirty", "dirty" },
+        { "writeback", "writeback" },
+        { "swap", "swap" },
+        { "pgscan", "pgscan" },
+        { "pgsteal", "pgsteal" },
+    };
+    static const std::vector<std::pair<std::string, std::string>> unified = {
+        { "cache", "file" },
+        { "rss", "anon" },
+        { "mapped", "file_mapped" },
+        { "dirty", "file_dirty" },
+        { "writeback", "file_writeback" },
+        { "pgscan", "pgscan" },
+        { "pgsteal", "pgsteal" },
+    };
+    std::string prefix = hierarchical && !Unified ? "total_" : "";
+    TUintMap raw;
+    uint64_t val;
+
+    TError error = cg.GetUintMap(STAT, raw);
+    if (error)
+        return error;
+
+    for (auto &field: Unified ? unified : legacy) {
+        auto it = raw.find(prefix + field.second);
+        if (it != raw.end())
+            stat[field.first] = it->second;
+    }
+
+    if (Unified) {
+        TUintMap events;
+
+        if (cg.Has(SWAP_CURRENT) && !cg.GetUint64(SWAP_CURRENT, val))
+            stat["swap"] = val;
+
+        if (!hierarchical && cg.Has(EVENTS_LOCAL))
+            error = cg.GetUintMap(EVENTS_LOCAL, events);
+        else
+            error = cg.GetUintMap(EVENTS, events);
+        if (!error)
+            stat["failcnt"] = events["max"];
+    } else {
+        error = cg.GetUint64(FAIL_CNT, val);
+        if (!error)
+            stat["failcnt"] = val;
+    }
+
+    return error;
+}
+
+TError TMemorySubsystem::GetFailCnt(TCgroup &cg, uint64_t &cnt) {
+    if (Unified) {
+        TUintMap events;
+        TError error = cg.GetUintMap(EVENTS, events);
+        if (!error)
+            cnt = events["oom_kill"];
+        return error;
+    }
+    return cg.GetUint64(FAIL_CNT, cnt);
+}
+
+/* Processes killed by kernel OOM killer, unlike failcnt doesn't count reclaim */
+TError TMemorySubsystem::GetOomKills(TCgroup &cg, uint64_t &cnt) {
+    TUintMap events;
+    TError error = cg.GetUintMap(Unified ? EVENTS : OOM_CONTROL, events);
+    if (!error)
+        cnt = events["oom_kill"];
+    return error;
+}
+
 TError TMemorySubsystem::SetLimit(TCgroup &cg, uint64_t limit) {
     std::string str_limit = limit ? std::to_string(limit) : "-1";
     uint64_t memswap;
 
+    if (Unified)
+        return cg.Set(MAX, limit ? std::to_string(limit) : "max");
+
     /* Memory limit cannot be bigger than Memory+Swap limit. */
     if (SupportSwap() && !cg.GetUint64(MEM_SWAP_LIMIT, memswap) &&
             (!limit || memswap < limit))
@@ -332,15 +738,75 @@ TError TMemorySubsystem::SetAnonLimit(TCgroup &cg, uint64_t limit) const {
     return TError::Success();
 }
 
+/* Reclaim and throttling starts above this limit, zero means unlimited */
+TError TMemorySubsystem::SetHighLimit(TCgroup &cg, uint64_t limit) const {
+    if (Unified)
+        return cg.Set(HIGH, limit ? std::to_string(limit) : "max");
+    if (cg.Has(HIGH_LIMIT))
+        return cg.Set(HIGH_LIMIT, limit ? std::to_string(limit) : "-1");
+    return TError::Success();
+}
+
+/* Count of times usage went over high limit */
+TError TMemorySubsystem::GetHighEvents(TCgroup &cg, uint64_t &count) const {
+    TUintMap events;
+
+    if (!cg.Has(EVENTS))
+        return TError(EError::NotSupported, "Memory events are not available");
+
+    TError error = cg.GetUintMap(EVENTS, events);
+    if (!error)
+        count = events["high"];
+    return error;
+}
+
+/* Time tasks stalled in memory reclaim and high limit throttling, ns */
+TError TMemorySubsystem::GetStallTime(TCgroup &cg, uint64_t &value) const {
+    if (!cg.Has(PRESSURE))
+        return TError(EError::NotSupported, "Memory pressure is not available");
+    return GetPressureTotal(cg, PRESSURE, value);
+}
+
+/* cgroup v2 io.max is per-device: apply limit to every physical disk */
+static TError SetIoMax(TCgroup &cg, const std::string &read,
+                       const std::string &write, uint64_t limit) {
+    std::vector<std::string> disks;
+    TPath sysBlock("/sys/block");
+
+    TError error = sysBlock.ReadDirectory(disks);
+    if (error)
+        return error;
+
+    std::string value = limit ? std::to_string(limit) : "max";
+    for (auto &disk: disks) {
+        std::string majmin;
+
+        if (!(sysBlock / disk / "device").Exists() ||
+                (sysBlock / disk / "dev").ReadAll(majmin))
+            continue;
+
+        error = cg.Set(MemorySubsystem.IO_MAX, StringTrim(majmin) + " " +
+                       read + "=" + value + " " + write + "=" + value);
+        if (error)
+            return error;
+    }
+
+    return TError::Success();
+}
+
 TError TMemorySubsystem::SetIoLimit(TCgroup &cg, uint64_t limit) {
     if (!SupportIoLimit())
         return TError::Success();
+    if (Unified)
+        return SetIoMax(cg, "rbps", "wbps", limit);
     return cg.SetUint64(FS_BPS_LIMIT, limit);
 }
 
 TError TMemorySubsystem::SetIopsLimit(TCgroup &cg, uint64_t limit) {
     if (!SupportIoLimit())
         return TError::Success();
+    if (Unified)
+        return SetIoMax(cg, "riops", "wiops", limit);
     return cg.SetUint64(FS_IOPS_LIMIT, limit);
 }
 
@@ -356,6 +822,14 @@ TError TMemorySubsystem::SetupOOMEvent(TCgroup &cg, int &fd) {
     TError error;
     int cfd;
 
+    /* cgroup v2 has no oom eventfd, oom is detected by memory.events */
+    if (Unified) {
+        fd = -1;
+        if (cg.Has(OOM_GROUP))
+            return cg.SetBool(OOM_GROUP, true);
+        return TError::Success();
+    }
+
     fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
     if (fd < 0)
         return TError(EError::Unknown, errno, "Cannot create eventfd");
@@ -374,19 +848,32 @@ TError TMemorySubsystem::SetupOOMEvent(TCgroup &cg, int &fd) {
 }
 
 // Freezer
+std::string TFreezerSubsystem::GetState(TCgroup &cg) const {
+    TError error;
+
+    if (Unified) {
+        TUintMap events;
+        error = cg.GetUintMap("cgroup.events", events);
+        if (!error)
+            return events["frozen"] ? "FROZEN" : "THAWED";
+    } else {
+        std::string state;
+        error = cg.Get("freezer.state", state);
+        if (!error)
+            return StringTrim(state);
+    }
+
+    L_ERR() << "Can't get freezer state: " << error << std::endl;
+    return "?";
+}
+
 TError TFreezerSubsystem::WaitState(TCgroup &cg,
                                     const std::string &state) const {
     int ret;
     if (!RetryIfFailed([&] {
-                std::string s;
-                TError error = cg.Get("freezer.state", s);
-                if (error)
-                    L_ERR() << "Can't freeze cgroup: " << error << std::endl;
-
-                return StringTrim(s) != state;
+                return GetState(cg) != state;
             }, ret, config().daemon().freezer_wait_timeout_s() * 10, 100) || ret) {
-        std::string s = "?";
-        (void)cg.Get("freezer.state", s);
+        std::string s = GetState(cg);
 
         TError error(EError::Unknown, "Can't wait " + std::to_string(config().daemon().freezer_wait_timeout_s()) + "s for freezer state " + state + ", current state is " + s);
         if (error)
@@ -397,10 +884,14 @@ TError TFreezerSubsystem::WaitState(TCgroup &cg,
 }
 
 TError TFreezerSubsystem::Freeze(TCgroup &cg) const {
+    if (Unified)
+        return cg.SetBool("cgroup.freeze", true);
     return cg.Set("freezer.state", "FROZEN");
 }
 
 TError TFreezerSubsystem::Unfreeze(TCgroup &cg) const {
+    if (Unified)
+        return cg.SetBool("cgroup.freeze", false);
     return cg.Set("freezer.state", "THAWED");
 }
 
@@ -414,6 +905,12 @@ TError TFreezerSubsystem::WaitForUnfreeze(TCgroup &cg) const {
 
 bool TFreezerSubsystem::IsFrozen(TCgroup &cg) const {
     std::string s;
+
+    if (Unified) {
+        bool frozen;
+        return !cg.GetBool("cgroup.freeze", frozen) && frozen;
+    }
+
     TError error = cg.Get("freezer.state", s);
     if (error)
         return false;
@@ -424,6 +921,26 @@ bool TFreezerSubsystem::IsFrozen(TCgroup &cg) const {
 void TCpuSubsystem::InitializeSubsystem() {
     TCgroup cg = RootCgroup();
 
+    if (Unified) {
+        std::vector<std::string> controllers;
+        std::string value;
+
+        if (!cg.Get("cgroup.controllers", value))
+            (void)SplitString(StringTrim(value), ' ', controllers);
+
+        /* cpu.weight and cpu.max, shares are converted into weight */
+        HasShares = HasQuota = std::find(controllers.begin(), controllers.end(),
+                                         "cpu") != controllers.end();
+        HasReserve = HasSmart = false;
+        BaseShares = 1024;
+        BasePeriod = 100000;
+
+        L_SYS() << GetNumCores() << " cores" << std::endl;
+        if (HasQuota)
+            L_SYS() << "unified cpu controller, period " << BasePeriod << std::endl;
+        return;
+    }
+
     HasShares = cg.Has("cpu.shares");
     if (HasShares && cg.GetUint64("cpu.shares", BaseShares))
         BaseShares = 1024;
@@ -464,7 +981,11 @@ TError TCpuSubsystem::SetCpuPolicy(TCgroup &cg, const std::string &policy,
         if (limit >= GetNumCores())
             quota = -1;
 
-        error = cg.Set("cpu.cfs_quota_us", std::to_string(quota));
+        if (Unified)
+            error = cg.Set("cpu.max", (quota < 0 ? std::string("max") :
+                           std::to_string(quota)) + " " + std::to_string(BasePeriod));
+        else
+            error = cg.Set("cpu.cfs_quota_us", std::to_string(quota));
         if (error)
             return error;
     }
@@ -502,7 +1023,12 @@ TError TCpuSubsystem::SetCpuPolicy(TCgroup &cg, const std::string &policy,
         else if (policy == "idle")
             shares /= 16;
 
-        error = cg.SetUint64("cpu.shares", shares);
+        if (Unified) {
+            /* cpu.weight: 1..10000, default 100 */
+            uint64_t weight = shares * 100 / BaseShares;
+            error = cg.SetUint64("cpu.weight", std::min(std::max(weight, 1ul), 10000ul));
+        } else
+            error = cg.SetUint64("cpu.shares", shares);
         if (error)
             return error;
     }
@@ -517,9 +1043,38 @@ TError TCpuSubsystem::SetCpuPolicy(TCgroup &cg, const std::string &policy,
     return TError::Success();
 }
 
+/* Periods when cpu_limit was hit and time tasks spent throttled, ns */
+TError TCpuSubsystem::GetThrottling(TCgroup &cg, uint64_t &periods, uint64_t &time) const {
+    TUintMap stat;
+
+    if (!HasQuota)
+        return TError(EError::NotSupported, "Cpu bandwidth control is not supported");
+
+    TError error = cg.GetUintMap("cpu.stat", stat);
+    if (error)
+        return error;
+
+    periods = stat["nr_throttled"];
+    if (Unified)
+        time = stat["throttled_usec"] * 1000;
+    else
+        time = stat["throttled_time"];
+
+    return TError::Success();
+}
+
 // Cpuacct
 TError TCpuacctSubsystem::Usage(TCgroup &cg, uint64_t &value) const {
     std::string s;
+
+    if (Unified) {
+        TUintMap stat;
+        TError error = cg.GetUintMap("cpu.stat", stat);
+        if (!error)
+            value = stat["usage_usec"] * 1000;
+        return error;
+    }
+
     TError error = cg.Get("cpuacct.usage", s);
     if (error)
         return error;
@@ -528,6 +1083,14 @@ TError TCpuacctSubsystem::Usage(TCgroup &cg, uint64_t &value) const {
 
 TError TCpuacctSubsystem::SystemUsage(TCgroup &cg, uint64_t &value) const {
     TUintMap stat;
+
+    if (Unified) {
+        TError error = cg.GetUintMap("cpu.stat", stat);
+        if (!error)
+            value = stat["system_usec"] * 1000;
+        return error;
+    }
+
     TError error = cg.GetUintMap("cpuacct.stat", stat);
     if (error)
         return error;
@@ -535,6 +1098,23 @@ TError TCpuacctSubsystem::SystemUsage(TCgroup &cg, uint64_t &value) const {
     return TError::Success();
 }
 
+/*
+ * Time runnable tasks spent waiting for cpu, ns. Legacy hierarchy needs
+ * cpuacct.wait from patched kernel, unified one takes stall time from psi.
+ */
+TError TCpuacctSubsystem::WaitTime(TCgroup &cg, uint64_t &value) const {
+    if (Unified) {
+        if (!cg.Has("cpu.pressure"))
+            return TError(EError::NotSupported, "Cpu pressure is not available");
+        return GetPressureTotal(cg, "cpu.pressure", value);
+    }
+
+    if (!cg.Has("cpuacct.wait"))
+        return TError(EError::NotSupported, "Cpu wait time is not available");
+
+    return cg.GetUint64("cpuacct.wait", value);
+}
+
 // Netcls
 
 // Blkio
@@ -563,10 +1143,49 @@ TError TBlkioSubsystem::GetDevice(const std::string &majmin,
     return error;
 }
 
+/* cgroup v2 io.stat: "MAJ:MIN rbytes=N wbytes=N rios=N wios=N ..." */
+TError TBlkioSubsystem::UnifiedStatistics(TCgroup &cg, bool ops,
+                                          std::vector<BlkioStat> &stat) const {
+    std::vector<std::string> lines;
+    TError error = cg.Knob("io.stat").ReadLines(lines);
+    if (error)
+        return error;
+
+    for (auto &line: lines) {
+        std::vector<std::string> tokens;
+        TUintMap values;
+        BlkioStat s = {};
+
+        error = SplitString(line, ' ', tokens);
+        if (error)
+            return error;
+        if (tokens.size() < 2 || GetDevice(tokens[0], s.Device))
+            continue;
+
+        for (size_t i = 1; i < tokens.size(); i++) {
+            auto sep = tokens[i].find('=');
+            uint64_t val;
+            if (sep != std::string::npos &&
+                    !StringToUint64(tokens[i].substr(sep + 1), val))
+                values[tokens[i].substr(0, sep)] = val;
+        }
+
+        s.Read = values[ops ? "rios" : "rbytes"];
+        s.Write = values[ops ? "wios" : "wbytes"];
+        stat.push_back(s);
+    }
+
+    return TError::Success();
+}
+
 TError TBlkioSubsystem::Statistics(TCgroup &cg,
                                    const std::string &file,
                                    std::vector<BlkioStat> &stat) const {
     std::vector<std::string> lines;
+
+    if (Unified)
+        return UnifiedStatistics(cg, file.find("serviced") != std::string::npos, stat);
+
     TError error = cg.Knob(file).ReadLines(lines);
     if (error)
         return error;
@@ -605,65 +1224,380 @@ TError TBlkioSubsystem::Statistics(TCgroup &cg,
     return TError::Success();
 }
 
-TError TBlkioSubsystem::SetPolicy(TCgroup &cg, bool batch) {
+TError TBlkioSubsystem::GetDiskDevice(const std::string &disk,
+                                      std::string &majmin) const {
+    TError error = TPath("/sys/block/" + disk + "/dev").ReadAll(majmin);
+    if (error)
+        return TError(EError::InvalidValue, "Unknown disk " + disk);
+    majmin = StringTrim(majmin);
+    return TError::Success();
+}
+
+/*
+ * Weights are given in blkio.weight units: 10..1000. Zero "default" means
+ * weight from io_policy, zero for disk resets per-disk weight.
+ */
+TError TBlkioSubsystem::SetPolicy(TCgroup &cg, bool batch, const TUintMap &weight) {
     if (!SupportPolicy())
         return TError::Success();
 
-    std::string rootWeight;
-    if (!batch) {
-        TError error = RootCgroup().Get("blkio.weight", rootWeight);
-        if (error)
+    auto it = weight.find("default");
+    uint64_t def = it != weight.end() ? it->second : 0;
+    TError error;
+
+    /* io.weight: 1..10000, default 100, five times less than blkio.weight */
+    if (Unified) {
+        if (!def)
+            def = batch ? config().container().batch_io_weight() : 500;
+        error = cg.Set("io.weight", "default " + std::to_string(std::max(def / 5, 1lu)));
+    } else {
+        std::string val;
+        if (def)
+            val = std::to_string(def);
+        else if (batch)
+            val = std::to_string(config().container().batch_io_weight());
+        else if (RootCgroup().Get("blkio.weight", val))
             return TError(EError::Unknown, "Can't get root blkio.weight");
+        error = cg.Set("blkio.weight", val);
     }
+    if (error)
+        return error;
+
+    for (auto &w: weight) {
+        std::string majmin;
+
+        if (w.first == "default")
+            continue;
+
+        error = GetDiskDevice(w.first, majmin);
+        if (error)
+            return error;
+
+        if (Unified)
+            error = cg.Set("io.weight", majmin + " " + (w.second ?
+                        std::to_string(std::max(w.second / 5, 1lu)) :
+                        std::string("default")));
+        else
+            error = cg.Set("blkio.weight_device", majmin + " " + std::to_string(w.second));
+        if (error)
+            return error;
+    }
+
+    return TError::Success();
+}
+
+/* Current weights in kernel units: "default" and per-disk overrides */
+TError TBlkioSubsystem::GetWeight(TCgroup &cg, TUintMap &weight) const {
+    std::vector<std::string> lines;
+    TError error;
+
+    if (Unified) {
+        error = cg.Knob("io.weight").ReadLines(lines);
+    } else {
+        std::string val;
+        error = cg.Get("blkio.weight", val);
+        if (!error)
+            error = StringToUint64(StringTrim(val), weight["default"]);
+        if (!error && cg.Has("blkio.weight_device"))
+            error = cg.Knob("blkio.weight_device").ReadLines(lines);
+    }
+    if (error)
+        return error;
 
-    return cg.Set("blkio.weight", batch ? std::to_string(config().container().batch_io_weight()) : rootWeight);
+    for (auto &line: lines) {
+        std::vector<std::string> tokens;
+        std::string device;
+        uint64_t val;
+
+        error = SplitString(StringReplaceAll(line, "\t", " "), ' ', tokens);
+        if (error)
+            return error;
+        if (tokens.size() != 2 || StringToUint64(tokens[1], val))
+            continue;
+
+        if (tokens[0] == "default")
+            weight["default"] = val;
+        else if (!GetDevice(tokens[0], device))
+            weight[device] = val;
+    }
+
+    return TError::Success();
+}
+
+/*
+ * Per-disk shares of cgroup among its siblings which did io to that disk:
+ * received - of transferred bytes, entitled - of weights, both in permille.
+ */
+TError TBlkioSubsystem::GetShares(TCgroup &cg, TUintMap &received,
+                                  TUintMap &entitled) const {
+    std::vector<TCgroup> siblings;
+    TUintMap totalBytes, totalWeight, bytes, weight;
+
+    if (cg.IsRoot()) {
+        siblings.push_back(cg);
+    } else {
+        TError error = cg.Parent().Childs(siblings);
+        if (error)
+            return error;
+    }
+
+    for (auto &sibling: siblings) {
+        std::vector<BlkioStat> stat;
+        TUintMap sibWeight;
+
+        /* sibling might be destroyed meanwhile */
+        if (Statistics(sibling, "blkio.io_service_bytes_recursive", stat) ||
+                GetWeight(sibling, sibWeight))
+            continue;
+
+        for (auto &s: stat) {
+            uint64_t b = s.Read + s.Write;
+            if (!b)
+                continue;
+
+            auto it = sibWeight.find(s.Device);
+            uint64_t w = it != sibWeight.end() ? it->second : sibWeight["default"];
+
+            totalBytes[s.Device] += b;
+            totalWeight[s.Device] += w;
+            if (sibling == cg) {
+                bytes[s.Device] = b;
+                weight[s.Device] = w;
+            }
+        }
+    }
+
+    for (auto &it: bytes) {
+        auto &disk = it.first;
+        received[disk] = (double)it.second * 1000 / totalBytes[disk];
+        entitled[disk] = totalWeight[disk] ?
+            (double)weight[disk] * 1000 / totalWeight[disk] : 0;
+    }
+
+    return TError::Success();
 }
 
 bool TBlkioSubsystem::SupportPolicy() {
+    if (Unified)
+        return Cgroup(PORTO_DAEMON_CGROUP).Has("io.weight");
     return RootCgroup().Has("blkio.weight");
 }
 
 // Devices
 
-TError TDevicesSubsystem::ApplyDefault(TCgroup &cg) {
-    TError error = cg.Set("devices.deny", "a");
-    if (error)
-        return error;
+//FIXME 'm' required only for start
+static const std::vector<std::string> DefaultDeviceRules = {
+    "c 1:3 rwm",     // /dev/null
+    "c 1:5 rwm",     // /dev/zero
+    "c 1:7 rwm",     // /dev/full
+    "c 1:8 rwm",     // /dev/random
+    "c 1:9 rwm",     // /dev/urandom
+    "c 5:0 rwm",     // /dev/tty
+    "c 5:2 rw",     // /dev/ptmx
+    "c 136:* rw",   // /dev/pts/*
+    "c 254:0 rm",   // /dev/rtc0         FIXME
+    "c 10:237 rmw", // /dev/loop-control FIXME
+    "b 7:* rmw"     // /dev/loop*        FIXME
+};
+
+#ifdef BPF_F_ALLOW_MULTI
+
+static struct bpf_insn BpfInsn(uint8_t code, uint8_t dst, uint8_t src,
+                               int16_t off, int32_t imm) {
+    struct bpf_insn insn;
+
+    memset(&insn, 0, sizeof(insn));
+    insn.code = code;
+    insn.dst_reg = dst;
+    insn.src_reg = src;
+    insn.off = off;
+    insn.imm = imm;
+    return insn;
+}
 
-    //FIXME 'm' required only for start
-    std::vector<std::string> rules = {
-        "c 1:3 rwm",     // /dev/null
-        "c 1:5 rwm",     // /dev/zero
-        "c 1:7 rwm",     // /dev/full
-        "c 1:8 rwm",     // /dev/random
-        "c 1:9 rwm",     // /dev/urandom
-        "c 5:0 rwm",     // /dev/tty
-        "c 5:2 rw",     // /dev/ptmx
-        "c 136:* rw",   // /dev/pts/*
-        "c 254:0 rm",   // /dev/rtc0         FIXME
-        "c 10:237 rmw", // /dev/loop-control FIXME
-        "b 7:* rmw"     // /dev/loop*        FIXME
+/*
+ * Compiles final access of each device into cgroup device filter.
+ * Restricted: access is granted if some entry covers all requested bits.
+ * Otherwise: access is denied if some deny entry has any requested bit.
+ */
+static TError LoadDeviceProgram(const TDeviceRules &rules, bool restrict, int &fd) {
+    std::vector<std::pair<std::string, int>> access;
+    std::vector<struct bpf_insn> prog;
+
+    auto apply = [&access] (const std::string &rule, bool allow) {
+        std::string dev = rule.substr(0, rule.rfind(' '));
+        int bits = 0;
+
+        for (char c: rule.substr(rule.rfind(' ') + 1))
+            bits |= c == 'm' ? BPF_DEVCG_ACC_MKNOD :
+                    c == 'r' ? BPF_DEVCG_ACC_READ :
+                    c == 'w' ? BPF_DEVCG_ACC_WRITE : 0;
+
+        for (auto &it: access) {
+            if (it.first == dev) {
+                it.second = allow ? (it.second | bits) : (it.second & ~bits);
+                return;
+            }
+        }
+        if (allow)
+            access.push_back(std::make_pair(dev, bits));
     };
 
-    for (auto &rule: rules) {
-        error = cg.Set("devices.allow", rule);
+    if (restrict) {
+        for (auto &rule: DefaultDeviceRules)
+            apply(rule, true);
+        for (auto &rule: rules.Allow)
+            apply(rule, true);
+        for (auto &rule: rules.Deny)
+            apply(rule, false);
+    } else {
+        /* like devices.deny in v1 deny wins over allow */
+        for (auto &rule: rules.Deny)
+            apply(rule, true);
+    }
+
+    /* r2 - type, r3 - access, r4 - major, r5 - minor */
+    prog.push_back(BpfInsn(BPF_LDX | BPF_W | BPF_MEM, 2, 1, 0, 0));
+    prog.push_back(BpfInsn(BPF_ALU | BPF_MOV | BPF_X, 3, 2, 0, 0));
+    prog.push_back(BpfInsn(BPF_ALU | BPF_AND | BPF_K, 2, 0, 0, 0xffff));
+    prog.push_back(BpfInsn(BPF_ALU | BPF_RSH | BPF_K, 3, 0, 0, 16));
+    prog.push_back(BpfInsn(BPF_LDX | BPF_W | BPF_MEM, 4, 1, 4, 0));
+    prog.push_back(BpfInsn(BPF_LDX | BPF_W | BPF_MEM, 5, 1, 8, 0));
+
+    for (auto &it: access) {
+        unsigned major, minor;
+        char type;
+        bool wildcard = it.first.back() == '*';
+
+        if (!it.second)
+            continue;
+
+        if (wildcard ? sscanf(it.first.c_str(), "%c %u:*", &type, &major) != 2 :
+                sscanf(it.first.c_str(), "%c %u:%u", &type, &major, &minor) != 3)
+            return TError(EError::Unknown, "Cannot parse device rule " + it.first);
+
+        int16_t len = wildcard ? 7 : 8, pos = 0;
+        int32_t devType = type == 'b' ? BPF_DEVCG_DEV_BLOCK : BPF_DEVCG_DEV_CHAR;
+
+        prog.push_back(BpfInsn(BPF_JMP | BPF_JNE | BPF_K, 2, 0, len - ++pos, devType));
+        prog.push_back(BpfInsn(BPF_ALU | BPF_MOV | BPF_X, 1, 3, 0, 0)); pos++;
+        if (restrict) {
+            prog.push_back(BpfInsn(BPF_ALU | BPF_AND | BPF_K, 1, 0, 0, ~it.second)); pos++;
+            prog.push_back(BpfInsn(BPF_JMP | BPF_JNE | BPF_K, 1, 0, len - ++pos, 0));
+        } else {
+            prog.push_back(BpfInsn(BPF_ALU | BPF_AND | BPF_K, 1, 0, 0, it.second)); pos++;
+            prog.push_back(BpfInsn(BPF_JMP | BPF_JEQ | BPF_K, 1, 0, len - ++pos, 0));
+        }
+        prog.push_back(BpfInsn(BPF_JMP | BPF_JNE | BPF_K, 4, 0, len - ++pos, major));
+        if (!wildcard)
+            prog.push_back(BpfInsn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, len - ++pos, minor));
+        prog.push_back(BpfInsn(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, restrict ? 1 : 0));
+        prog.push_back(BpfInsn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+    }
+
+    prog.push_back(BpfInsn(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, restrict ? 0 : 1));
+    prog.push_back(BpfInsn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_CGROUP_DEVICE;
+    attr.insns = (uint64_t)(uintptr_t)prog.data();
+    attr.insn_cnt = prog.size();
+    attr.license = (uint64_t)(uintptr_t)"GPL";
+
+    fd = syscall(__NR_bpf, BPF_PROG_LOAD, &attr, sizeof(attr));
+    if (fd < 0)
+        return TError(EError::NotSupported, errno, "bpf(BPF_PROG_LOAD)");
+
+    return TError::Success();
+}
+
+static TError AttachDeviceProgram(TCgroup &cg, TDeviceRules &rules, bool restrict) {
+    std::lock_guard<std::mutex> lock(rules.Mutex);
+    TScopedFd &program = restrict ? rules.Program : rules.DenyProgram;
+    TError error;
+
+    if (program.GetFd() < 0) {
+        int fd = -1;
+        error = LoadDeviceProgram(rules, restrict, fd);
         if (error)
-            break;
+            return error;
+        program = fd;
     }
 
+    int dirfd = open(cg.Path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0)
+        return TError(EError::Unknown, errno, "open(" + cg.Path().ToString() + ")");
+
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.target_fd = dirfd;
+    attr.attach_bpf_fd = program.GetFd();
+    attr.attach_type = BPF_CGROUP_DEVICE;
+    attr.attach_flags = BPF_F_ALLOW_MULTI;
+
+    L_ACT() << "Attach device filter to " << cg << std::endl;
+    if (syscall(__NR_bpf, BPF_PROG_ATTACH, &attr, sizeof(attr)) < 0)
+        error = TError(EError::NotSupported, errno, "bpf(BPF_PROG_ATTACH)");
+
+    close(dirfd);
     return error;
 }
 
-TError TDevicesSubsystem::ApplyDevice(TCgroup &cg, const TDevice &device) {
-    std::string rule;
+#else
+
+static TError AttachDeviceProgram(TCgroup &cg, TDeviceRules &rules, bool restrict) {
+    return TError(EError::NotSupported, "Built without cgroup device filters");
+}
+
+#endif
+
+TError TDevicesSubsystem::ApplyRules(TCgroup &cg, TDeviceRules &rules,
+                                     bool restrict) {
     TError error;
 
-    rule = device.CgroupRule(true);
-    if (rule != "")
-        error = cg.Set("devices.allow", rule);
-    rule = device.CgroupRule(false);
-    if (!error && rule != "")
-        error = cg.Set("devices.deny", rule);
+    /* cgroup v2 device control requires bpf programs */
+    if (Unified) {
+        if (!restrict && rules.Deny.empty())
+            return TError::Success();
+        /* never run container without device filter it asked for */
+        error = AttachDeviceProgram(cg, rules, restrict);
+        if (error)
+            return TError(error, "Cannot restrict devices in " + cg.Name);
+        return TError::Success();
+    }
+
+    std::vector<std::string> allow;
+
+    if (restrict) {
+        error = cg.Set("devices.deny", "a");
+        if (error)
+            return error;
+        allow = DefaultDeviceRules;
+    }
+
+    allow.insert(allow.end(), rules.Allow.begin(), rules.Allow.end());
+
+    error = cg.SetLines("devices.allow", allow);
+    if (!error)
+        error = cg.SetLines("devices.deny", rules.Deny);
+    return error;
+}
+
+/* Zero means unlimited */
+TError TPidsSubsystem::SetLimit(TCgroup &cg, uint64_t limit) const {
+    if (!Supported() || cg.IsRoot())
+        return TError::Success();
+    return cg.Set(MAX, limit ? std::to_string(limit) : "max");
+}
+
+/* Forks failed in this subtree because of some limit */
+TError TPidsSubsystem::GetRejected(TCgroup &cg, uint64_t &count) const {
+    TUintMap events;
+
+    TError error = cg.GetUintMap(EVENTS, events);
+    if (!error)
+        count = events["max"];
     return error;
 }
 
@@ -674,6 +1608,7 @@ TCpuacctSubsystem   CpuacctSubsystem;
 TNetclsSubsystem    NetclsSubsystem;
 TBlkioSubsystem     BlkioSubsystem;
 TDevicesSubsystem   DevicesSubsystem;
+TPidsSubsystem      PidsSubsystem;
 
 std::vector<TSubsystem *> AllSubsystems = {
     { &MemorySubsystem   },
@@ -683,6 +1618,7 @@ std::vector<TSubsystem *> AllSubsystems = {
     { &NetclsSubsystem   },
     { &BlkioSubsystem    },
     { &DevicesSubsystem  },
+    { &PidsSubsystem     },
 };
 
 std::vector<TSubsystem *> Subsystems;
@@ -695,6 +1631,30 @@ TError InitializeCgroups() {
     TMount mount;
     TError error;
 
+    if (config.Simulate()) {
+        L() << "Simulate cgroups at " << root << std::endl;
+
+        for (auto subsys: AllSubsystems) {
+            subsys->Root = root / subsys->Type;
+            subsys->Simulated = true;
+            subsys->Hierarchy = subsys;
+
+            error = subsys->Root.MkdirAll(0755);
+            if (!error)
+                error = SimulateKnobs(subsys->RootCgroup());
+            if (error) {
+                L_ERR() << "Cannot create simulated cgroup " << subsys->Type << " : " << error << std::endl;
+                return error;
+            }
+
+            Subsystems.push_back(subsys);
+            Hierarchies.push_back(subsys);
+            subsys->InitializeSubsystem();
+        }
+
+        return TError::Success();
+    }
+
     error = mount.Find(root);
     if (error) {
         L_ERR() << "Cannot find cgroups root mount: " << error << std::endl;
@@ -709,6 +1669,28 @@ TError InitializeCgroups() {
         }
     }
 
+    if (mount.GetMountpoint() == root && mount.GetType() == "cgroup2") {
+        L() << "Found unified cgroup hierarchy at " << root << std::endl;
+
+        /* one directory per container, freezer stands for whole hierarchy */
+        for (auto subsys: AllSubsystems) {
+            subsys->Root = root;
+            subsys->Unified = true;
+            subsys->Hierarchy = &FreezerSubsystem;
+            Subsystems.push_back(subsys);
+        }
+        Hierarchies.push_back(&FreezerSubsystem);
+
+        EnableControllers(FreezerSubsystem.RootCgroup());
+
+        L_WRN() << "Devices and net_cls controllers are not supported in unified hierarchy" << std::endl;
+
+        for (auto subsys: AllSubsystems)
+            subsys->InitializeSubsystem();
+
+        return TError::Success();
+    }
+
     error = TMount::Snapshot(mounts);
     if (error) {
         L_ERR() << "Can't create mount snapshot: " << error << std::endl;
@@ -739,6 +1721,12 @@ TError InitializeCgroups() {
             }
 
             error = subsys->Root.Mount("cgroup", "cgroup", 0, {subsys->Type});
+            if (error && subsys == &PidsSubsystem) {
+                L_WRN() << "Cannot mount optional cgroup " << subsys->Type << ": " << error << std::endl;
+                (void)subsys->Root.Rmdir();
+                subsys->Root = TPath();
+                continue;
+            }
             if (error) {
                 L_ERR() << "Cannot mount cgroup: " << error << std::endl;
                 (void)subsys->Root.Rmdir();
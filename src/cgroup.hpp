@@ -1,11 +1,13 @@
 #pragma once
 
 #include <string>
+#include <map>
 
 #include "common.hpp"
 #include "util/path.hpp"
 
 struct TDevice;
+struct TDeviceRules;
 class TCgroup;
 
 class TSubsystem {
@@ -13,6 +15,8 @@ public:
     const std::string Type;
     const TSubsystem *Hierarchy;
     TPath Root;
+    bool Unified = false; /* cgroup v2: all controllers in one hierarchy */
+    bool Simulated = false; /* plain directories with knob files */
 
     TSubsystem(const std::string &type) : Type(type) { }
     virtual void InitializeSubsystem() { }
@@ -23,10 +27,23 @@ public:
     TError TaskCgroup(pid_t pid, TCgroup &cgroup) const;
 };
 
+/*
+ * Values last written into knobs, keyed by knob path.
+ * Saved with container state, so restore needs no reads.
+ */
+struct TKnobCache {
+    std::map<std::string, std::string> Values;
+
+    void Clear() {
+        Values.clear();
+    }
+};
+
 class TCgroup {
 public:
     const TSubsystem *Subsystem;
     std::string Name;
+    TKnobCache *Applied = nullptr; /* skip writes of unchanged values */
 
     TCgroup() { }
     TCgroup(const TSubsystem *subsystem, const std::string &name) :
@@ -52,6 +69,7 @@ public:
         return lhs.Name != rhs.Name;
     }
 
+    TCgroup Parent() const;
     TCgroup Child(const std::string& name) const;
     TError Childs(std::vector<TCgroup> &cgroups) const;
     TError ChildsAll(std::vector<TCgroup> &cgroups) const;
@@ -61,7 +79,9 @@ public:
     bool Exists() const;
 
     TError Create() const;
+    TError RemoveDir() const;
     TError Remove() const;
+    TError RemoveSubtree() const;
 
     TError KillAll(int signal) const;
 
@@ -70,6 +90,8 @@ public:
     }
 
     TError GetTasks(std::vector<pid_t> &pids) const {
+        if (Subsystem && Subsystem->Unified)
+            return GetPids("cgroup.threads", pids);
         return GetPids("tasks", pids);
     }
 
@@ -81,6 +103,7 @@ public:
     bool Has(const std::string &knob) const;
     TError Get(const std::string &knob, std::string &value) const;
     TError Set(const std::string &knob, const std::string &value) const;
+    TError SetLines(const std::string &knob, const std::vector<std::string> &lines) const;
 
     TError GetPids(const std::string &knob, std::vector<pid_t> &pids) const;
 
@@ -112,36 +135,60 @@ public:
     const std::string ANON_USAGE = "memory.anon.usage";
     const std::string ANON_LIMIT = "memory.anon.limit";
     const std::string FAIL_CNT = "memory.failcnt";
+    const std::string HIGH_LIMIT = "memory.high_limit_in_bytes";
+
+    /* cgroup v2 */
+    const std::string CURRENT = "memory.current";
+    const std::string MAX = "memory.max";
+    const std::string LOW = "memory.low";
+    const std::string EVENTS = "memory.events";
+    const std::string OOM_GROUP = "memory.oom.group";
+    const std::string PEAK = "memory.peak";
+    const std::string EVENTS_LOCAL = "memory.events.local";
+    const std::string SWAP_CURRENT = "memory.swap.current";
+    const std::string HIGH = "memory.high";
+    const std::string PRESSURE = "memory.pressure";
+    const std::string IO_MAX = "io.max";
 
     TMemorySubsystem() : TSubsystem("memory") {}
 
-    TError Statistics(TCgroup &cg, TUintMap &stat) const {
-        return cg.GetUintMap(STAT, stat);
-    }
+    TError Statistics(TCgroup &cg, TUintMap &stat) const;
+    TError GetMemoryStat(TCgroup &cg, bool hierarchical, TUintMap &stat) const;
 
     TError Usage(TCgroup &cg, uint64_t &value) const {
-        return cg.GetUint64(USAGE, value);
+        return cg.GetUint64(Unified ? CURRENT : USAGE, value);
     }
 
+    /* there is no soft limit in cgroup v2 */
     TError GetSoftLimit(TCgroup &cg, uint64_t &limit) const {
+        if (Unified) {
+            limit = 0;
+            return TError::Success();
+        }
         return cg.GetUint64(SOFT_LIMIT, limit);
     }
 
     TError SetSoftLimit(TCgroup &cg, uint64_t limit) const {
+        if (Unified)
+            return TError::Success();
         return cg.SetUint64(SOFT_LIMIT, limit);
     }
 
     bool SupportGuarantee() const {
+        if (Unified)
+            return Cgroup(PORTO_DAEMON_CGROUP).Has(LOW);
         return RootCgroup().Has(LOW_LIMIT);
     }
 
     TError SetGuarantee(TCgroup &cg, uint64_t guarantee) const {
         if (!SupportGuarantee())
             return TError::Success();
-        return cg.SetUint64(LOW_LIMIT, guarantee);
+        return cg.SetUint64(Unified ? LOW : LOW_LIMIT, guarantee);
     }
 
     bool SupportIoLimit() const {
+        if (Unified)
+            return Cgroup(PORTO_DAEMON_CGROUP).Has(IO_MAX);
         return RootCgroup().Has(FS_BPS_LIMIT);
     }
 
@@ -167,21 +214,36 @@ public:
     bool SupportAnonLimit() const;
     TError SetAnonLimit(TCgroup &cg, uint64_t limit) const;
 
+    bool SupportHighLimit() const {
+        return Cgroup(PORTO_DAEMON_CGROUP).Has(Unified ? HIGH : HIGH_LIMIT);
+    }
+
+    TError SetHighLimit(TCgroup &cg, uint64_t limit) const;
+    TError GetHighEvents(TCgroup &cg, uint64_t &count) const;
+    TError GetStallTime(TCgroup &cg, uint64_t &value) const;
+    bool SupportHighEvents() const {
+        return Cgroup(PORTO_DAEMON_CGROUP).Has(EVENTS);
+    }
+    bool SupportStallTime() const {
+        return Cgroup(PORTO_DAEMON_CGROUP).Has(PRESSURE);
+    }
+
     TError SetLimit(TCgroup &cg, uint64_t limit);
     TError SetIoLimit(TCgroup &cg, uint64_t limit);
     TError SetIopsLimit(TCgroup &cg, uint64_t limit);
     TError SetDirtyLimit(TCgroup &cg, uint64_t limit);
     TError SetupOOMEvent(TCgroup &cg, int &fd);
 
-    TError GetFailCnt(TCgroup &cg, uint64_t &cnt) {
-        return cg.GetUint64(FAIL_CNT, cnt);
-    }
+    TError GetFailCnt(TCgroup &cg, uint64_t &cnt);
+    TError GetOomKills(TCgroup &cg, uint64_t &cnt);
 };
 
 class TFreezerSubsystem : public TSubsystem {
 public:
     TFreezerSubsystem() : TSubsystem("freezer") {}
 
+    std::string GetState(TCgroup &cg) const;
+
     TError WaitState(TCgroup &cg,
                      const std::string &state) const;
     TError Freeze(TCgroup &cg) const;
@@ -200,6 +262,7 @@ public:
     void InitializeSubsystem() override;
     TError SetCpuPolicy(TCgroup &cg, const std::string &policy,
                         double guarantee, double limit);
+    TError GetThrottling(TCgroup &cg, uint64_t &periods, uint64_t &time) const;
 };
 
 class TCpuacctSubsystem : public TSubsystem {
@@ -207,6 +270,12 @@ public:
     TCpuacctSubsystem() : TSubsystem("cpuacct") {}
     TError Usage(TCgroup &cg, uint64_t &value) const;
     TError SystemUsage(TCgroup &cg, uint64_t &value) const;
+    TError WaitTime(TCgroup &cg, uint64_t &value) const;
+    bool SupportWaitTime() const {
+        if (Unified)
+            return Cgroup(PORTO_DAEMON_CGROUP).Has("cpu.pressure");
+        return RootCgroup().Has("cpuacct.wait");
+    }
 };
 
 class TNetclsSubsystem : public TSubsystem {
@@ -229,20 +298,56 @@ class TBlkioSubsystem : public TSubsystem {
                        uint64_t &val) const;
     TError GetDevice(const std::string &majmin,
                      std::string &device) const;
+    TError UnifiedStatistics(TCgroup &cg, bool ops,
+                             std::vector<BlkioStat> &stat) const;
 public:
     TBlkioSubsystem() : TSubsystem("blkio") {}
     TError Statistics(TCgroup &cg,
                       const std::string &file,
                       std::vector<BlkioStat> &stat) const;
-    TError SetPolicy(TCgroup &cg, bool batch);
+    TError GetDiskDevice(const std::string &disk,
+                         std::string &majmin) const;
+    TError SetPolicy(TCgroup &cg, bool batch, const TUintMap &weight);
     bool SupportPolicy();
+    bool SupportDeviceWeight() const {
+        return Unified || RootCgroup().Has("blkio.weight_device");
+    }
+    TError GetWeight(TCgroup &cg, TUintMap &weight) const;
+    TError GetShares(TCgroup &cg, TUintMap &received, TUintMap &entitled) const;
+
+    /* cfq time and queue statistics, absent in cgroup v2 */
+    bool SupportTimeStats() const {
+        return !Unified && RootCgroup().Has("blkio.io_service_time_recursive");
+    }
 };
 
 class TDevicesSubsystem : public TSubsystem {
 public:
     TDevicesSubsystem() : TSubsystem("devices") {}
-    TError ApplyDefault(TCgroup &cg);
-    TError ApplyDevice(TCgroup &cg, const TDevice &device);
+    TError ApplyRules(TCgroup &cg, TDeviceRules &rules, bool restrict);
+};
+
+class TPidsSubsystem : public TSubsystem {
+public:
+    const std::string MAX = "pids.max";
+    const std::string CURRENT = "pids.current";
+    const std::string EVENTS = "pids.events";
+
+    TPidsSubsystem() : TSubsystem("pids") {}
+
+    /* optional: old kernels have no pids controller */
+    bool Supported() const {
+        if (Unified)
+            return Cgroup(PORTO_DAEMON_CGROUP).Has(MAX);
+        return Hierarchy != nullptr;
+    }
+
+    TError Usage(TCgroup &cg, uint64_t &value) const {
+        return cg.GetUint64(CURRENT, value);
+    }
+
+    TError SetLimit(TCgroup &cg, uint64_t limit) const;
+    TError GetRejected(TCgroup &cg, uint64_t &count) const;
 };
 
 extern TMemorySubsystem     MemorySubsystem;
@@ -252,6 +357,7 @@ extern TCpuacctSubsystem    CpuacctSubsystem;
 extern TNetclsSubsystem     NetclsSubsystem;
 extern TBlkioSubsystem      BlkioSubsystem;
 extern TDevicesSubsystem    DevicesSubsystem;
+extern TPidsSubsystem       PidsSubsystem;
 
 extern std::vector<TSubsystem *> AllSubsystems;
 extern std::vector<TSubsystem *> Subsystems;
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <map>
+#include <tuple>
 
 #include "rpc.hpp"
 #include "client.hpp"
@@ -154,7 +156,9 @@ TError TClient::IdentifyClient(TContainerHolder &holder, bool initial) {
         Cred = ct->OwnerCred;
     }
 
-    ReadOnlyAccess = !Cred.IsPortoUser();
+    /* unprivileged simulation has no porto group, trust its owner */
+    ReadOnlyAccess = !Cred.IsPortoUser() &&
+                     !(config.Simulate() && Cred.Uid == getuid());
 
     return TError::Success();
 }
@@ -369,6 +373,120 @@ TError TClient::QueueResponse(rpc::TContainerResponse &response) {
     return SendResponse(true);
 }
 
+struct TRequestLimit {
+    TTokenBucket Bucket;
+    uint64_t InFlight = 0;
+    uint64_t Throttled = 0;
+    uint64_t Used = 0;
+    uint64_t Warned = 0;
+};
+
+static std::mutex RequestLimitsMutex;
+static std::map<uid_t, TRequestLimit> UserRequestLimits;
+static std::map<std::string, TRequestLimit> NamespaceRequestLimits;
+
+template <typename T>
+static TRequestLimit &GetRequestLimit(std::map<T, TRequestLimit> &limits,
+                                      const T &key, uint64_t rate,
+                                      uint64_t burst, uint64_t now) {
+    auto it = limits.find(key);
+
+    if (it == limits.end()) {
+        /* forget idle users and namespaces */
+        if (limits.size() >= 1024) {
+            for (it = limits.begin(); it != limits.end(); ) {
+                if (!it->second.InFlight && now - it->second.Used > 60000)
+                    it = limits.erase(it);
+                else
+                    it++;
+            }
+        }
+        it = limits.emplace(std::piecewise_construct,
+                            std::forward_as_tuple(key),
+                            std::forward_as_tuple()).first;
+        it->second.Bucket.Configure(rate, burst, now);
+    }
+
+    it->second.Used = now;
+    return it->second;
+}
+
+TError TClient::AcquireRequest() {
+    auto &cfg = config().daemon();
+
+    if (!cfg.client_request_rate() && !cfg.client_max_requests() &&
+            !cfg.namespace_request_rate())
+        return TError::Success();
+
+    std::string ns = "";
+    auto ct = ClientContainer.lock();
+    if (ct)
+        ns = ct->GetPortoNamespace();
+
+    uint64_t now = GetCurrentTimeMs();
+    TRequestLimit *limit, *nsLimit = nullptr;
+    uint64_t delay;
+    TError error;
+
+    std::lock_guard<std::mutex> lock(RequestLimitsMutex);
+
+    limit = &GetRequestLimit(UserRequestLimits, Cred.Uid,
+                             cfg.client_request_rate(),
+                             cfg.client_request_burst(), now);
+
+    /* host clients are limited only per user */
+    if (ns != "" && cfg.namespace_request_rate())
+        nsLimit = &GetRequestLimit(NamespaceRequestLimits, ns,
+                                   cfg.namespace_request_rate(),
+                                   cfg.namespace_request_burst(), now);
+
+    if (cfg.client_max_requests() && limit->InFlight >= cfg.client_max_requests()) {
+        error = TError(EError::Throttled, "Too many concurrent requests from user " +
+                       Cred.User() + ", retry later");
+    } else if ((delay = limit->Bucket.Peek(now))) {
+        error = TError(EError::Throttled, "Request rate limit for user " +
+                       Cred.User() + " exceeded, retry in " +
+                       std::to_string(delay) + " ms");
+    } else if (nsLimit && (delay = nsLimit->Bucket.Peek(now))) {
+        limit = nsLimit;
+        error = TError(EError::Throttled, "Request rate limit for namespace " +
+                       ns + " exceeded, retry in " +
+                       std::to_string(delay) + " ms");
+    } else {
+        /* charge only requests allowed by both limits */
+        limit->Bucket.Take(now);
+        if (nsLimit)
+            nsLimit->Bucket.Take(now);
+    }
+
+    if (error) {
+        limit->Throttled++;
+        Statistics->RequestsThrottled++;
+        if (now - limit->Warned >= 1000) {
+            limit->Warned = now;
+            L_WRN() << "Throttle " << *this << ": " << error << ", "
+                    << limit->Throttled << " requests throttled" << std::endl;
+        }
+        return error;
+    }
+
+    limit->InFlight++;
+    RequestUid = Cred.Uid;
+
+    return TError::Success();
+}
+
+void TClient::ReleaseRequest() {
+    if (RequestUid < 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(RequestLimitsMutex);
+    auto it = UserRequestLimits.find(RequestUid);
+    if (it != UserRequestLimits.end() && it->second.InFlight)
+        it->second.InFlight--;
+    RequestUid = -1;
+}
+
 std::ostream& operator<<(std::ostream& stream, TClient& client) {
     if (client.FullLog) {
         client.FullLog = false;
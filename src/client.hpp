@@ -8,6 +8,7 @@
 #include "epoll.hpp"
 #include "util/cred.hpp"
 #include "util/unix.hpp"
+#include "util/ratelimit.hpp"
 
 class TContainer;
 class TContainerHolder;
@@ -56,6 +57,13 @@ public:
 
     std::shared_ptr<TContainerWaiter> Waiter;
 
+    /* Deadline for request waiting for busy container */
+    uint64_t QueueDeadline = 0;
+
+    /* Charge per-user and per-namespace request limits */
+    TError AcquireRequest();
+    void ReleaseRequest();
+
     TError ReadRequest(rpc::TContainerRequest &request);
     bool ReadInterrupted();
 
@@ -75,6 +83,7 @@ private:
     TError LoadGroups();
 
     bool FullLog = true;
+    int RequestUid = -1;
 
     uint64_t Length = 0;
     uint64_t Offset = 0;
@@ -47,12 +47,28 @@ void TConfig::LoadDefaults() {
     config().mutable_daemon()->set_workers(4);
     config().mutable_daemon()->set_max_msg_len(32 * 1024 * 1024);
     config().mutable_daemon()->set_event_workers(1);
+    config().mutable_daemon()->set_cgroup_reconcile_period_ms(60 * 1000);
+    config().mutable_daemon()->set_cgroup_reconcile_slice_ms(20);
+    // lost containers are checked at this period, reconciler walk starts from it
+    config().mutable_daemon()->set_cgroup_reconcile_lost_period_ms(5000);
+    config().mutable_daemon()->set_hierarchy_verify_period_ms(60 * 60 * 1000);
+    config().mutable_daemon()->set_criu_path("criu");
 
     config().mutable_container()->set_max_log_size(10 * 1024 * 1024);
     config().mutable_container()->set_tmp_dir("/place/porto");
     config().mutable_container()->set_chroot_porto_dir("porto");
     config().mutable_container()->set_default_aging_time_s(60 * 60 * 24);
     config().mutable_container()->set_respawn_delay_ms(1000);
+    config().mutable_container()->set_respawn_max_delay_ms(60 * 1000);
+    // host-wide limit for respawns, zero rate means unlimited
+    config().mutable_container()->set_start_rate(50);
+    config().mutable_container()->set_start_burst(100);
+    config().mutable_container()->set_request_queue_size(16);
+    config().mutable_container()->set_request_queue_timeout_ms(60 * 1000);
+    // parsed device lists are shared by containers with the same config
+    config().mutable_container()->set_device_cache_ms(60 * 1000);
+    // per-container history of oom kills, see oom_events
+    config().mutable_container()->set_max_oom_events(16);
     config().mutable_container()->set_stdout_limit(8 * 1024 * 1024);
     config().mutable_container()->set_private_max(1024);
     config().mutable_container()->set_kill_timeout_ms(1000);
@@ -78,6 +94,22 @@ void TConfig::LoadDefaults() {
     config().mutable_privileges()->set_enforce_bind_permissions(false);
 }
 
+/* Simulation keeps all daemon state in one directory, host isn't touched */
+void TConfig::LoadSimulation() {
+    TPath dir(config().daemon().simulate_dir());
+
+    config().mutable_slave_pid()->set_path((dir / "portod.pid").ToString());
+    config().mutable_slave_log()->set_path((dir / "portod.log").ToString());
+    config().mutable_master_pid()->set_path((dir / "portoloop.pid").ToString());
+    config().mutable_master_log()->set_path((dir / "portoloop.log").ToString());
+    config().mutable_keyval()->mutable_file()->set_path((dir / "kvs").ToString());
+    config().mutable_volumes()->mutable_keyval()->mutable_file()->set_path((dir / "pkvs").ToString());
+    config().mutable_daemon()->set_sysfs_root((dir / "cgroup").ToString());
+    config().mutable_container()->set_tmp_dir((dir / "porto").ToString());
+    config().mutable_volumes()->set_volume_dir((dir / "porto_volumes").ToString());
+    config().mutable_volumes()->set_layers_dir((dir / "porto_layers").ToString());
+}
+
 bool TConfig::LoadFile(const std::string &path) {
     TScopedFd fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
     if (fd.GetFd() < 0)
@@ -107,6 +139,11 @@ void TConfig::Load() {
     }
 
 load_cred:
+    if (!SimulateDir.empty())
+        config().mutable_daemon()->set_simulate_dir(SimulateDir);
+    if (Simulate())
+        LoadSimulation();
+
     Verbose |= config().log().verbose();
 
     InitCred();
@@ -4,8 +4,6 @@
 
 #include "common.hpp"
 
-#undef PROTOBUF_DEPRECATED
-#define PROTOBUF_DEPRECATED __attribute__((deprecated))
 #include "config.pb.h"
 #undef PROTOBUF_DEPRECATED
 
@@ -16,11 +14,20 @@ class TConfig : public TNonCopyable {
 
     void LoadDefaults();
     bool LoadFile(const std::string &path);
+    void LoadSimulation();
 public:
+    /* Set by --simulate, applied on every reload */
+    std::string SimulateDir;
+
     TConfig() {}
     void Load();
     int Test(const std::string &path);
     cfg::TCfg &operator()();
+
+    /* Fake kernel: cgroups are plain directories, no namespaces and network */
+    bool Simulate() const {
+        return !Cfg.daemon().simulate_dir().empty();
+    }
 };
 
 extern TConfig config;
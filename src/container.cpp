@@ -24,11 +24,13 @@
 #include "util/cred.hpp"
 #include "util/unix.hpp"
 #include "client.hpp"
+#include "rpc.hpp"
 #include "stream.hpp"
 #include "kv.pb.h"
 
 extern "C" {
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/reboot.h>
@@ -39,6 +41,7 @@ extern "C" {
 }
 
 std::mutex ContainersMutex;
+TTokenBucket StartRateLimit;
 std::map<std::string, std::shared_ptr<TContainer>> Containers;
 
 using std::string;
@@ -86,13 +89,16 @@ TContainer::TContainer(std::shared_ptr<TContainerHolder> holder,
 
     StdoutLimit = config().container().stdout_limit();
     MemLimit = 0;
+    MemHighLimit = 0;
     AnonMemLimit = 0;
     DirtyMemLimit = 0;
+    ThreadLimit = 0;
     RechargeOnPgfault = false;
     CpuPolicy = "normal";
     CpuLimit = GetNumCores();
     CpuGuarantee = 0;
     IoPolicy = "normal";
+    IoWeight["default"] = 0;
     IoLimit = 0;
     IopsLimit = 0;
 
@@ -101,6 +107,7 @@ TContainer::TContainer(std::shared_ptr<TContainerHolder> holder,
         config().network().default_guarantee();
 
     NetLimit["default"] = 0;
+    NetRxLimit["default"] = 0;
     NetPriority["default"] = NET_DEFAULT_PRIO;
     ToRespawn = false;
     MaxRespawns = -1;
@@ -198,6 +205,30 @@ TError TContainer::RotateStdFile(TStdStream &stream, uint64_t &offset_value) {
     off_t loss;
     TError error = stream.Rotate(config().container().max_log_size(), loss);
 
+    /* Tail is copied to the head, freeze writers to not lose their output */
+    if (error.GetError() == EError::NotSupported) {
+        auto cg = GetCgroup(FreezerSubsystem);
+        bool frozen = FreezerSubsystem.IsFrozen(cg);
+
+        if (!frozen) {
+            error = FreezerSubsystem.Freeze(cg);
+            if (!error)
+                error = FreezerSubsystem.WaitForFreeze(cg);
+        }
+
+        if (!error)
+            error = stream.Rotate(config().container().max_log_size(), loss, true);
+
+        if (!frozen) {
+            TError error2 = FreezerSubsystem.Unfreeze(cg);
+            if (!error2)
+                error2 = FreezerSubsystem.WaitForUnfreeze(cg);
+            if (error2)
+                L_ERR() << "Can't unfreeze " << GetName() << " after log rotation: "
+                        << error2 << std::endl;
+        }
+    }
+
     if (!error && loss) {
             offset_value += loss;
     }
@@ -248,11 +279,42 @@ void TContainer::SyncStateWithCgroup(TScopedLock &holder_lock) {
 }
 
 TError TContainer::GetStat(ETclassStat stat, std::map<std::string, uint64_t> &m) {
-    if (Net) {
-        auto lock = Net->ScopedLock();
-        return Net->GetTrafficCounters(Id, stat, m);
-    } else
+    if (!Net)
         return TError(EError::NotSupported, "Network statistics is not available");
+
+    std::map<std::string, std::pair<int, int>> links;
+    std::map<std::string, int> peers;
+    TError error;
+
+    {
+        auto lock = Net->ScopedLock();
+        error = Net->GetTrafficCounters(Id, stat, m);
+        if (error)
+            return error;
+
+        if ((stat == ETclassStat::RxDrops || stat == ETclassStat::RxOverlimits) &&
+                Parent && Parent->Net && Net != Parent->Net)
+            error = Net->GetVethLinks(links);
+        if (error)
+            return error;
+    }
+
+    /* Packets dropped by ingress shaper at host side of veth */
+    if (!links.empty()) {
+        auto lock = Parent->Net->ScopedLock();
+        error = Parent->Net->GetVethPeers(links, peers);
+        if (error)
+            return error;
+        for (auto &peer: peers) {
+            uint64_t value;
+            error = Parent->Net->GetIngressCounter(peer.second, stat, value);
+            if (error)
+                return error;
+            m[peer.first] += value;
+        }
+    }
+
+    return TError::Success();
 }
 
 void TContainer::UpdateRunningChildren(size_t diff) {
@@ -313,6 +375,7 @@ void TContainer::SetState(EContainerState newState) {
     }
 
     State = newState;
+    UpdateHierarchy();
 
     if (newState != EContainerState::Running && newState != EContainerState::Meta)
         NotifyWaiters();
@@ -375,6 +438,17 @@ void TContainer::Destroy(TScopedLock &holder_lock) {
     L_ACT() << "Destroy " << GetName() << " " << Id << std::endl;
 
     SetState(EContainerState::Unknown);
+
+    if (HierarchyLinked) {
+        Parent->ChildrenMemGuarantee -= HierarchyMemGuarantee;
+        if (SubtreeMemLimit)
+            Parent->ChildrenMemLimit -= SubtreeMemLimit;
+        else
+            Parent->UnlimitedChildren--;
+        HierarchyLinked = false;
+        Parent->UpdateHierarchy();
+    }
+
     DestroyVolumes(holder_lock);
     if (Net) {
         auto lock = Net->ScopedLock();
@@ -437,41 +511,13 @@ TError TContainer::OpenNetns(TNamespaceFd &netns) const {
 }
 
 uint64_t TContainer::GetHierarchyMemGuarantee(void) const {
-    uint64_t val = 0lu;
-
-    for (auto iter : Children)
-        if (auto child = iter.lock())
-            val += child->GetHierarchyMemGuarantee();
-
-    return (CurrentMemGuarantee > val) ? CurrentMemGuarantee : val;
+    return HierarchyMemGuarantee;
 }
 
 uint64_t TContainer::GetHierarchyMemLimit(std::shared_ptr<const TContainer> root) const {
-    uint64_t val = MemLimit;
+    uint64_t val = SubtreeMemLimit;
     std::shared_ptr<const TContainer> p = shared_from_this();
 
-    if (State == EContainerState::Meta) {
-        auto children_limit = 0lu;
-
-        for (auto iter : p->Children) {
-            if (auto child = iter.lock()) {
-                auto child_limit = child->GetHierarchyMemLimit(p);
-
-                if (child_limit) {
-                    children_limit += child_limit;
-                } else {
-                    children_limit = 0;
-                    break;
-                }
-            }
-        }
-
-        if (children_limit)
-            val = val > 0 ?
-                  (val > children_limit ? children_limit : val)
-                  : children_limit;
-    }
-
     while (p != root) {
 
         if (p->MemLimit)
@@ -485,6 +531,89 @@ uint64_t TContainer::GetHierarchyMemLimit(std::shared_ptr<const TContainer> root
     return val;
 }
 
+static uint64_t SubtreeLimit(uint64_t limit, EContainerState state,
+                             uint64_t children, size_t unlimited) {
+    if (state == EContainerState::Meta && !unlimited && children)
+        return limit ? std::min(limit, children) : children;
+    return limit;
+}
+
+void TContainer::UpdateHierarchy() {
+    for (auto ct = this; ct; ct = ct->Parent.get()) {
+        uint64_t guarantee = std::max(ct->CurrentMemGuarantee,
+                                      ct->ChildrenMemGuarantee);
+        uint64_t limit = SubtreeLimit(ct->MemLimit, ct->State,
+                                      ct->ChildrenMemLimit,
+                                      ct->UnlimitedChildren);
+
+        if (guarantee == ct->HierarchyMemGuarantee &&
+                limit == ct->SubtreeMemLimit)
+            break;
+
+        if (ct->HierarchyLinked) {
+            auto parent = ct->Parent.get();
+
+            parent->ChildrenMemGuarantee += guarantee - ct->HierarchyMemGuarantee;
+
+            if (ct->SubtreeMemLimit)
+                parent->ChildrenMemLimit -= ct->SubtreeMemLimit;
+            else
+                parent->UnlimitedChildren--;
+            if (limit)
+                parent->ChildrenMemLimit += limit;
+            else
+                parent->UnlimitedChildren++;
+        }
+
+        ct->HierarchyMemGuarantee = guarantee;
+        ct->SubtreeMemLimit = limit;
+
+        if (!ct->HierarchyLinked)
+            break;
+    }
+}
+
+int TContainer::VerifyHierarchy() {
+    uint64_t guarantee = 0, limit = 0;
+    size_t unlimited = 0, running = State == EContainerState::Running;
+    int mismatches = 0;
+
+    for (auto iter : Children) {
+        auto child = iter.lock();
+        if (child && child->HierarchyLinked) {
+            mismatches += child->VerifyHierarchy();
+            guarantee += child->HierarchyMemGuarantee;
+            if (child->SubtreeMemLimit)
+                limit += child->SubtreeMemLimit;
+            else
+                unlimited++;
+            running += child->RunningChildren;
+        }
+    }
+
+    if (guarantee != ChildrenMemGuarantee || limit != ChildrenMemLimit ||
+            unlimited != UnlimitedChildren || running != RunningChildren ||
+            HierarchyMemGuarantee != std::max(CurrentMemGuarantee, guarantee) ||
+            SubtreeMemLimit != SubtreeLimit(MemLimit, State, limit, unlimited)) {
+        L_ERR() << "Hierarchy aggregates mismatch in " << GetName()
+                << ": guarantee " << ChildrenMemGuarantee << " != " << guarantee
+                << " limit " << ChildrenMemLimit << " != " << limit
+                << " unlimited " << UnlimitedChildren << " != " << unlimited
+                << " running " << RunningChildren << " != " << running
+                << std::endl;
+        mismatches++;
+    }
+
+    ChildrenMemGuarantee = guarantee;
+    ChildrenMemLimit = limit;
+    UnlimitedChildren = unlimited;
+    RunningChildren = running;
+    HierarchyMemGuarantee = std::max(CurrentMemGuarantee, guarantee);
+    SubtreeMemLimit = SubtreeLimit(MemLimit, State, limit, unlimited);
+
+    return mismatches;
+}
+
 vector<pid_t> TContainer::Processes() {
     auto cg = GetCgroup(FreezerSubsystem);
 
@@ -494,7 +623,7 @@ vector<pid_t> TContainer::Processes() {
 }
 
 TError TContainer::ApplyDynamicProperties() {
-    auto memcg = GetCgroup(MemorySubsystem);
+    auto memcg = GetKnobCgroup(MemorySubsystem);
     TError error;
 
     error = MemorySubsystem.SetGuarantee(memcg, MemGuarantee);
@@ -512,6 +641,12 @@ TError TContainer::ApplyDynamicProperties() {
         return error;
     }
 
+    error = MemorySubsystem.SetHighLimit(memcg, MemHighLimit);
+    if (error) {
+        L_ERR() << "Can't set " << P_MEM_HIGH_LIMIT << ": " << error << std::endl;
+        return error;
+    }
+
     error = MemorySubsystem.SetAnonLimit(memcg, AnonMemLimit);
     if (error) {
         L_ERR() << "Can't set " << P_ANON_LIMIT << ": " << error << std::endl;
@@ -524,7 +659,7 @@ TError TContainer::ApplyDynamicProperties() {
         return error;
     }
 
-    auto cpucg = GetCgroup(CpuSubsystem);
+    auto cpucg = GetKnobCgroup(CpuSubsystem);
     error = CpuSubsystem.SetCpuPolicy(cpucg,
             CpuPolicy,
             CpuGuarantee,
@@ -534,8 +669,8 @@ TError TContainer::ApplyDynamicProperties() {
         return error;
     }
 
-    auto blkcg = GetCgroup(BlkioSubsystem);
-    error = BlkioSubsystem.SetPolicy(blkcg, IoPolicy == "batch");
+    auto blkcg = GetKnobCgroup(BlkioSubsystem);
+    error = BlkioSubsystem.SetPolicy(blkcg, IoPolicy == "batch", IoWeight);
     if (error) {
         L_ERR() << "Can't set " << P_IO_POLICY << ": " << error << std::endl;
         return error;
@@ -559,6 +694,13 @@ TError TContainer::ApplyDynamicProperties() {
         return error;
     }
 
+    auto pidscg = GetKnobCgroup(PidsSubsystem);
+    error = PidsSubsystem.SetLimit(pidscg, ThreadLimit);
+    if (error) {
+        L_ERR() << "Can't set " << P_THREAD_LIMIT << ": " << error << std::endl;
+        return error;
+    }
+
     return TError::Success();
 }
 
@@ -590,6 +732,9 @@ TError TContainer::PrepareOomMonitor() {
         return error;
 
     OomEventFd = fd;
+    if (fd < 0)
+        return TError::Success();
+
     Source = std::make_shared<TEpollSource>(Holder->EpollLoop, fd,
                                             EPOLL_EVENT_OOM, shared_from_this());
 
@@ -601,56 +746,68 @@ TError TContainer::PrepareOomMonitor() {
 }
 
 TError TContainer::ConfigureDevices(std::vector<TDevice> &devices) {
-    auto config = Devices;
     auto cg = GetCgroup(DevicesSubsystem);
-    TDevice device;
+    std::shared_ptr<TDeviceRules> rules;
     TError error;
 
     if (IsRoot() || IsPortoRoot())
         return TError::Success();
 
-    if (Parent->IsPortoRoot() &&
-            (!config.empty() || !OwnerCred.IsRootUser())) {
-        error = DevicesSubsystem.ApplyDefault(cg);
-        if (error)
-            return error;
-    }
+    bool restrict = Parent->IsPortoRoot() &&
+                    (!Devices.empty() || !OwnerCred.IsRootUser());
 
-    for (auto &cfg: config) {
-        error = device.Parse(cfg);
-        if (error)
-            return TError(error, "device: " + cfg);
+    if (Devices.empty() && !restrict)
+        return TError::Success();
 
-        error = device.Permitted(OwnerCred);
-        if (error)
-            return TError(error, "device: " + cfg);
+    error = CompileDevices(Devices, rules);
+    if (error)
+        return error;
 
-        error = DevicesSubsystem.ApplyDevice(cg, device);
-        if (error)
-            return TError(error, "device: " + cfg);
+    error = rules->Permitted(OwnerCred);
+    if (error)
+        return error;
 
-        devices.push_back(device);
-    }
+    error = DevicesSubsystem.ApplyRules(cg, *rules, restrict);
+    if (error)
+        return TError(error, "devices");
+
+    devices = rules->Devices;
 
     return TError::Success();
 }
 
-TError TContainer::PrepareCgroups() {
+TError TContainer::PrepareCgroups(bool restore) {
+    bool created = false;
     TError error;
 
     for (auto hy: Hierarchies) {
         TCgroup cg = GetCgroup(*hy);
 
+        if (cg.Exists() && !restore && !IsRoot() && !IsPortoRoot()) {
+            /* leftover of previous container with this name, maybe populated */
+            L_WRN() << "Remove leftover cgroup " << cg << std::endl;
+            Statistics->CgroupRepairs++;
+            error = cg.RemoveSubtree();
+            if (error)
+                return TError(error, "Cannot remove leftover cgroup");
+        }
+
         if (cg.Exists()) //FIXME kludge for root and restore
             continue;
 
         error = cg.Create();
         if (error)
             return error;
+        created = true;
     }
 
-    if (IsPortoRoot()) {
-        error = GetCgroup(MemorySubsystem).SetBool(MemorySubsystem.USE_HIERARCHY, true);
+    /* fresh cgroups hold defaults, not values applied before */
+    if (created)
+        AppliedKnobs.Clear();
+
+    if (IsPortoRoot() && !MemorySubsystem.Unified) {
+        auto memcg = GetKnobCgroup(MemorySubsystem);
+        error = memcg.SetBool(MemorySubsystem.USE_HIERARCHY, true);
         if (error)
             return error;
     }
@@ -718,6 +875,10 @@ TError TContainer::ParseNetConfig(struct TNetCfg &NetCfg) {
 TError TContainer::PrepareNetwork(struct TNetCfg &NetCfg) {
     TError error;
 
+    /* Simulated containers share host network without traffic classes */
+    if (config.Simulate())
+        return TError::Success();
+
     error = NetCfg.PrepareNetwork();
     if (error)
         return error;
@@ -743,7 +904,11 @@ TError TContainer::PrepareNetwork(struct TNetCfg &NetCfg) {
         }
     }
 
-    if (!IsRoot()) {
+    error = UpdateIngressLimits();
+    if (error)
+        return error;
+
+    if (!IsRoot() && !NetclsSubsystem.Unified) {
         auto netcls = GetCgroup(NetclsSubsystem);
         error = netcls.Set("net_cls.classid",
                 std::to_string(TcHandle(ROOT_TC_MAJOR, Id)));
@@ -873,7 +1038,12 @@ TError TContainer::PrepareTask(std::shared_ptr<TClient> client,
         }
     }
 
-    if (parent && client) {
+    if (config.Simulate()) {
+        /* Plain fork and exec, see TTask::SimulateChild */
+        taskEnv->Simulate = true;
+        taskEnv->Isolate = false;
+        taskEnv->QuadroFork = false;
+    } else if (parent && client) {
         pid_t parent_pid = parent->Task->GetPid();
 
         error = taskEnv->ParentNs.Open(parent_pid);
@@ -885,10 +1055,10 @@ TError TContainer::PrepareTask(std::shared_ptr<TClient> client,
             taskEnv->TripleFork = true;
     }
 
-    if (NetCfg && NetCfg->NetNs.IsOpened())
+    if (NetCfg && NetCfg->NetNs.IsOpened() && !taskEnv->Simulate)
         taskEnv->ParentNs.Net.EatFd(NetCfg->NetNs);
 
-    if (NetCfg)
+    if (NetCfg && !taskEnv->Simulate)
         taskEnv->Autoconf = NetCfg->Autoconf;
 
     if (taskEnv->Command.empty() || taskEnv->TripleFork || taskEnv->QuadroFork) {
@@ -904,9 +1074,9 @@ TError TContainer::PrepareTask(std::shared_ptr<TClient> client,
     }
 
     // Create new mount namespaces if we have to make any changes
-    taskEnv->NewMountNs = taskEnv->Isolate ||
+    taskEnv->NewMountNs = !taskEnv->Simulate && (taskEnv->Isolate ||
                           taskEnv->BindMounts.size() || taskEnv->BindDns ||
-                          !taskEnv->Root.IsRoot() || taskEnv->RootRdOnly;
+                          !taskEnv->Root.IsRoot() || taskEnv->RootRdOnly);
 
     Task = std::unique_ptr<TTask>(new TTask(taskEnv));
 
@@ -915,6 +1085,14 @@ TError TContainer::PrepareTask(std::shared_ptr<TClient> client,
 
 void TContainer::AddChild(std::shared_ptr<TContainer> child) {
     Children.push_back(child);
+
+    ChildrenMemGuarantee += child->HierarchyMemGuarantee;
+    if (child->SubtreeMemLimit)
+        ChildrenMemLimit += child->SubtreeMemLimit;
+    else
+        UnlimitedChildren++;
+    child->HierarchyLinked = true;
+    UpdateHierarchy();
 }
 
 TError TContainer::Create(const TCred &cred) {
@@ -1045,7 +1223,14 @@ TError TContainer::Start(std::shared_ptr<TClient> client, bool meta) {
         goto error;
     }
 
-    if (!meta || (meta && Isolate)) {
+    if (!RestoreImage.IsEmpty()) {
+        error = RestoreTask();
+        if (error)
+            goto error;
+
+        RootPid = Task->GetPids();
+        PropMask |= ROOT_PID_SET;
+    } else if (!meta || (meta && Isolate)) {
 
         error = PrepareTask(client, &NetCfg);
         if (error)
@@ -1080,6 +1265,13 @@ TError TContainer::Start(std::shared_ptr<TClient> client, bool meta) {
     else
         SetState(EContainerState::Running);
     Statistics->Started++;
+
+    /* explicit starts aren't delayed but eat budget of respawns */
+    if (client) {
+        StartRateLimit.Charge(GetCurrentTimeMs());
+        RespawnAttempts = 0;
+    }
+
     error = UpdateSoftLimit();
     if (error)
         L_ERR() << "Can't update meta soft limit: " << error << std::endl;
@@ -1284,7 +1476,7 @@ TError TContainer::PrepareWorkDir() {
     return error;
 }
 
-TError TContainer::PrepareResources(std::shared_ptr<TClient> client) {
+TError TContainer::PrepareResources(std::shared_ptr<TClient> client, bool restore) {
     TError error;
 
     error = PrepareWorkDir();
@@ -1297,7 +1489,7 @@ TError TContainer::PrepareResources(std::shared_ptr<TClient> client) {
         return error;
     }
 
-    error = PrepareCgroups();
+    error = PrepareCgroups(restore);
     if (error) {
         L_ERR() << "Can't prepare task cgroups: " << error << std::endl;
         FreeResources();
@@ -1332,6 +1524,7 @@ void TContainer::FreeResources() {
             error = cg.Remove();
             (void)error; //Logged inside
         }
+        AppliedKnobs.Clear();
     }
 
     if (Net) {
@@ -1399,14 +1592,18 @@ void TContainer::FreeResources() {
 void TContainer::AcquireForced() {
     if (Verbose)
         L() << "Acquire " << GetName() << " (forced)" << std::endl;
-    Acquired++;
+    if (!Acquired++)
+        for (auto p = Parent; p; p = p->Parent)
+            p->AcquiredChildren++;
 }
 
 bool TContainer::Acquire() {
     if (!IsAcquired()) {
         if (Verbose)
             L() << "Acquire " << GetName() << std::endl;
-        Acquired++;
+        if (!Acquired++)
+            for (auto p = Parent; p; p = p->Parent)
+                p->AcquiredChildren++;
         return true;
     }
     return false;
@@ -1417,12 +1614,61 @@ void TContainer::Release() {
         L() << "Release " << GetName() << std::endl;
     PORTO_ASSERT(Acquired > 0);
     Acquired--;
+    if (!Acquired) {
+        for (auto p = Parent; p; p = p->Parent)
+            p->AcquiredChildren--;
+        DispatchQueuedRequests();
+    }
 }
 
 bool TContainer::IsAcquired() const {
     return (Acquired || (Parent && Parent->IsAcquired()));
 }
 
+bool TContainer::HasAcquiredChild() const {
+    return AcquiredChildren > 0;
+}
+
+void TContainer::PushQueuedRequest(const TQueuedRequest &request) {
+    QueuedRequests.push_back(request);
+    Holder->QueuedRequests++;
+}
+
+std::list<TQueuedRequest>::iterator
+TContainer::EraseQueuedRequest(std::list<TQueuedRequest>::iterator it) {
+    Holder->QueuedRequests--;
+    return QueuedRequests.erase(it);
+}
+
+void TContainer::ScheduleQueuedRequests() {
+    if (!Holder->QueuedRequests)
+        return;
+
+    if (!QueuedRequests.empty() && !QueueDispatched && RequeueRpcRequests &&
+            !IsAcquired() && !HasAcquiredChild()) {
+        QueueDispatched = true;
+        RequeueRpcRequests(shared_from_this());
+    }
+
+    for (auto &weakChild : Children)
+        if (auto child = weakChild.lock())
+            child->ScheduleQueuedRequests();
+}
+
+void TContainer::DispatchQueuedRequests() {
+    if (!Holder->QueuedRequests)
+        return;
+
+    // release could unblock whole subtree and ancestors busy by child
+    ScheduleQueuedRequests();
+    for (auto p = Parent; p; p = p->Parent)
+        if (!p->QueuedRequests.empty() && !p->QueueDispatched &&
+                RequeueRpcRequests && !p->IsAcquired() && !p->HasAcquiredChild()) {
+            p->QueueDispatched = true;
+            RequeueRpcRequests(p);
+        }
+}
+
 TError TContainer::Stop(TScopedLock &holder_lock, uint64_t timeout_ms) {
     auto state = GetState();
 
@@ -1559,6 +1805,286 @@ TError TContainer::Kill(int sig) {
     return Task->Kill(sig);
 }
 
+/* Host pid of task with given pid in innermost pid namespace */
+static pid_t FindHostPid(const TCgroup &cg, pid_t vpid) {
+    std::vector<pid_t> pids;
+
+    if (cg.GetProcesses(pids))
+        return 0;
+
+    for (auto pid: pids) {
+        std::vector<std::string> lines;
+        if (TPath("/proc/" + std::to_string(pid) + "/status").ReadLines(lines))
+            continue;
+        for (auto &line: lines) {
+            if (!StringStartsWith(line, "NSpid:"))
+                continue;
+            auto pos = line.find_last_of(" \t");
+            int nspid;
+            if (!StringToInt(line.substr(pos + 1), nspid) && nspid == vpid)
+                return pid;
+        }
+    }
+
+    return 0;
+}
+
+TError TContainer::Checkpoint(TScopedLock &holder_lock, const TPath &dir,
+                              TCheckpointPhases &phases) {
+    auto state = GetState();
+    if (state != EContainerState::Running)
+        return TError(EError::InvalidState, "invalid container state " +
+                      ContainerStateName(state));
+
+    for (auto iter : Children) {
+        auto child = iter.lock();
+        if (child && child->GetState() != EContainerState::Stopped)
+            return TError(EError::InvalidState, "Container has started children");
+    }
+
+    if (!Parent || !Parent->IsPortoRoot())
+        return TError(EError::NotSupported, "Checkpoint supported only for first level containers");
+
+    /* CRIU cannot recreate interfaces configured by porto */
+    if (Net != Parent->Net)
+        return TError(EError::NotSupported, "Checkpoint requires net=inherited");
+
+    if (!dir.IsAbsolute())
+        return TError(EError::InvalidValue, "Checkpoint path must be absolute");
+
+    /*
+     * CRIU handles single level of pid namespaces, for isolated
+     * application dump starts from init below portoinit waiter.
+     */
+    pid_t root = Task->GetWPid();
+    if (Isolate && InPidNamespace(root, getpid())) {
+        std::string children;
+        TError error = TPath("/proc/" + std::to_string(root) + "/task/" +
+                             std::to_string(root) + "/children").ReadAll(children);
+        if (!error)
+            error = StringToInt(StringTrim(children), root);
+        if (error)
+            return TError(error, "Cannot find init task");
+    }
+
+    TError error = dir.Mkdir(0700);
+    if (error)
+        return error;
+
+    L_ACT() << "Checkpoint " << GetName() << " into " << dir << std::endl;
+
+    uint64_t time = GetCurrentTimeMs();
+
+    error = Freeze(holder_lock);
+    if (error)
+        return error;
+
+    phases.emplace_back("freeze", GetCurrentTimeMs() - time);
+    time = GetCurrentTimeMs();
+
+    kv::TNode spec;
+    auto pair = spec.add_pairs();
+    pair->set_key(std::string(P_RAW_NAME));
+    pair->set_val(GetName());
+
+    TClient fakeroot(TCred(0,0));
+    CurrentContainer = this;
+    CurrentClient = &fakeroot;
+
+    /* user visible properties and pids, image is restored as new container */
+    for (auto knob : ContainerProperties) {
+        std::string value;
+
+        if (knob.first != P_RAW_ROOT_PID &&
+                (knob.second->IsReadOnly || knob.second->IsHidden ||
+                 !knob.second->IsSerializable ||
+                 !(PropMask & knob.second->SetMask)))
+            continue;
+
+        error = knob.second->Get(value);
+        if (error)
+            break;
+
+        pair = spec.add_pairs();
+        pair->set_key(knob.first);
+        pair->set_val(value);
+    }
+
+    CurrentContainer = nullptr;
+    CurrentClient = nullptr;
+
+    std::string text;
+    TPath specPath = dir / CHECKPOINT_SPEC;
+
+    if (!error && !spec.SerializeToString(&text))
+        error = TError(EError::Unknown, "Cannot serialize container spec");
+    if (!error)
+        error = specPath.Mkfile(0600);
+    if (!error)
+        error = specPath.WriteAll(text);
+    if (!error)
+        error = Stdout.SaveTo(dir / "stdout");
+    if (!error)
+        error = Stderr.SaveTo(dir / "stderr");
+    if (error) {
+        (void)Unfreeze(holder_lock);
+        return error;
+    }
+
+    phases.emplace_back("save", GetCurrentTimeMs() - time);
+    time = GetCurrentTimeMs();
+
+    TPath images = dir / "images";
+    error = images.Mkdir(0700);
+    if (error) {
+        (void)Unfreeze(holder_lock);
+        return error;
+    }
+
+    std::vector<std::string> command = {
+        config().daemon().criu_path(), "dump",
+        "--tree", std::to_string(root),
+        "--images-dir", images.ToString(),
+        "--log-file", (dir / "dump.log").ToString(),
+        "--freeze-cgroup", GetCgroup(FreezerSubsystem).Path().ToString(),
+        "--manage-cgroups=ignore",
+        "--tcp-established", "--file-locks", "--ext-unix-sk",
+    };
+
+    int status;
+    {
+        TScopedUnlock unlock(holder_lock);
+        error = Run(command, status);
+    }
+    if (!error && status)
+        error = TError(EError::Unknown, "Can't execute criu dump " +
+                       std::to_string(status) + ", see " + (dir / "dump.log").ToString());
+    if (error) {
+        L_WRN() << "Checkpoint " << GetName() << " failed: " << error << std::endl;
+        (void)Unfreeze(holder_lock);
+        return error;
+    }
+
+    phases.emplace_back("dump", GetCurrentTimeMs() - time);
+    time = GetCurrentTimeMs();
+
+    /* dumped tasks are killed by criu, cleanup the rest */
+    error = StopTree(holder_lock, 0);
+    if (error)
+        return error;
+
+    phases.emplace_back("stop", GetCurrentTimeMs() - time);
+
+    Statistics->Checkpoints++;
+
+    return TError::Success();
+}
+
+TError TContainer::ReadCheckpoint(const TPath &dir, std::string &name, std::vector<int> &pids,
+                                  std::vector<std::pair<std::string, std::string>> &properties) {
+    std::string text;
+    kv::TNode spec;
+
+    TError error = (dir / CHECKPOINT_SPEC).ReadAll(text, 16 << 20);
+    if (error)
+        return error;
+
+    if (!spec.ParseFromString(text))
+        return TError(EError::InvalidValue, "Cannot parse " + (dir / CHECKPOINT_SPEC).ToString());
+
+    for (auto &pair: spec.pairs()) {
+        if (pair.key() == P_RAW_NAME) {
+            name = pair.val();
+        } else if (pair.key() == P_RAW_ROOT_PID) {
+            std::vector<std::string> list;
+            error = StringToStrList(pair.val(), list);
+            if (!error)
+                error = StringsToIntegers(list, pids);
+            if (error)
+                return error;
+        } else
+            properties.emplace_back(pair.key(), pair.val());
+    }
+
+    return TError::Success();
+}
+
+/* Replaces task start for container created from checkpoint image */
+TError TContainer::RestoreTask() {
+    std::vector<int> pids = RestorePids;
+    TPath pidFile = RestoreImage / "restore.pid";
+    TPath logFile = RestoreImage / "restore.log";
+
+    if (pids.size() != 3)
+        return TError(EError::InvalidValue, "Checkpoint image has no root pid");
+
+    TError error = Stdout.LoadFrom(RestoreImage / "stdout");
+    if (!error)
+        error = Stderr.LoadFrom(RestoreImage / "stderr");
+    if (error)
+        return error;
+
+    if (pidFile.Exists())
+        (void)pidFile.Unlink();
+
+    std::vector<std::string> command = {
+        config().daemon().criu_path(), "restore",
+        "--images-dir", (RestoreImage / "images").ToString(),
+        "--log-file", logFile.ToString(),
+        "--pidfile", pidFile.ToString(),
+        "--restore-detached",
+        "--manage-cgroups=ignore",
+        "--tcp-established", "--file-locks", "--ext-unix-sk",
+    };
+
+    /* restored tasks inherit cgroups of criu */
+    std::vector<TCgroup> cgroups;
+    for (auto hy: Hierarchies)
+        cgroups.push_back(GetCgroup(*hy));
+
+    int status;
+    error = Run(command, status, false, [&cgroups]() -> TError {
+        for (auto &cg: cgroups) {
+            TError error = cg.Attach(getpid());
+            if (error)
+                return error;
+        }
+        return TError::Success();
+    });
+    if (error)
+        return error;
+
+    if (status)
+        return TError(EError::Unknown, "Can't execute criu restore " +
+                      std::to_string(status) + ", see " + logFile.ToString());
+
+    int root;
+    error = pidFile.ReadInt(root);
+    if (error)
+        return error;
+
+    /*
+     * Restored tree is reparented to portod master, it becomes waited task.
+     * Application keeps its pid inside namespace, find it from host.
+     */
+    pid_t appPid = root;
+    if (pids[0] != pids[2]) {
+        appPid = FindHostPid(GetCgroup(FreezerSubsystem), pids[1]);
+        if (!appPid) {
+            (void)GetCgroup(FreezerSubsystem).KillAll(SIGKILL);
+            return TError(EError::Unknown, "Cannot find restored task " +
+                          std::to_string(pids[1]));
+        }
+    }
+
+    Task = std::unique_ptr<TTask>(new TTask(root));
+    Task->Restore({ appPid, Isolate ? pids[1] : appPid, root });
+
+    L() << GetName() << " restored " << appPid << std::endl;
+
+    return TError::Success();
+}
+
 void TContainer::ParsePropertyName(std::string &name, std::string &idx) {
     std::vector<std::string> tokens;
     TError error = SplitString(name, '[', tokens);
@@ -1615,9 +2141,23 @@ TError TContainer::GetProperty(const string &origProperty, string &value,
     return error;
 }
 
-TError TContainer::SetProperty(const string &origProperty,
-                               const string &origValue,
-                               std::shared_ptr<TClient> &client) {
+/* Never touches container itself, only values committed by last Save() */
+TError TContainer::GetSnapshotProperty(const string &property, string &value) const {
+    auto snapshot = std::atomic_load(&Snapshot);
+    if (snapshot) {
+        auto it = snapshot->find(property);
+        if (it != snapshot->end()) {
+            value = it->second;
+            return TError::Success();
+        }
+    }
+
+    return TError(EError::Busy, "Can't get " + property + " of busy container");
+}
+
+TError TContainer::ApplyProperty(const string &origProperty,
+                                 const string &origValue,
+                                 std::shared_ptr<TClient> &client) {
     if (IsRoot() || IsPortoRoot())
         return TError(EError::Permission, "System containers are read only");
 
@@ -1643,6 +2183,13 @@ TError TContainer::SetProperty(const string &origProperty,
     CurrentContainer = nullptr;
     CurrentClient = nullptr;
 
+    return error;
+}
+
+TError TContainer::SetProperty(const string &property,
+                               const string &value,
+                               std::shared_ptr<TClient> &client) {
+    TError error = ApplyProperty(property, value, client);
     if (error)
         return error;
 
@@ -1652,10 +2199,24 @@ TError TContainer::SetProperty(const string &origProperty,
     return Save();
 }
 
+TError TContainer::SetProperties(const std::vector<std::pair<std::string, std::string>> &properties,
+                                 std::shared_ptr<TClient> &client) {
+    for (auto &prop: properties) {
+        TError error = ApplyProperty(prop.first, prop.second, client);
+        if (error)
+            return TError(error, "Cannot set " + prop.first);
+    }
+
+    return Save();
+}
+
 TError TContainer::RestoreNetwork() {
     TNamespaceFd netns;
     TError error;
 
+    if (config.Simulate())
+        return TError::Success();
+
     error = OpenNetns(netns);
     if (error)
         return error;
@@ -1683,6 +2244,10 @@ TError TContainer::RestoreNetwork() {
     if (error)
         return error;
 
+    error = UpdateIngressLimits();
+    if (error)
+        return error;
+
     return TError::Success();
 }
 
@@ -1739,10 +2304,19 @@ TError TContainer::Save(void) {
     pair->set_key(std::string(P_RAW_NAME));
     pair->set_val(GetName());
 
+    /* values in cgroup knobs, restore compares against them without reading */
+    for (auto &knob: AppliedKnobs.Values) {
+        pair = new_node.add_pairs();
+        pair->set_key(std::string(P_RAW_APPLIED_KNOB) + knob.first);
+        pair->set_val(knob.second);
+    }
+
     TClient fakeroot(TCred(0,0));
     CurrentContainer = this;
     CurrentClient = &fakeroot;
 
+    auto snapshot = std::make_shared<std::map<std::string, std::string>>();
+
     for (auto knob : ContainerProperties) {
         std::string value;
 
@@ -1757,8 +2331,16 @@ TError TContainer::Save(void) {
         auto pair = new_node.add_pairs();
         pair->set_key(knob.first);
         pair->set_val(value);
+
+        /* these are saved unconditionally but readable only when dead */
+        if (!knob.second->IsHidden &&
+                (State == EContainerState::Dead ||
+                 (knob.first != D_EXIT_STATUS && knob.first != D_OOM_KILLED)))
+            (*snapshot)[knob.first] = value;
     }
 
+    std::atomic_store(&Snapshot, std::shared_ptr<const std::map<std::string, std::string>>(snapshot));
+
     CurrentContainer = nullptr;
     CurrentClient = nullptr;
 
@@ -1792,6 +2374,11 @@ TError TContainer::Restore(TScopedLock &holder_lock, const kv::TNode &node) {
             continue;
         }
 
+        if (StringStartsWith(key, P_RAW_APPLIED_KNOB)) {
+            AppliedKnobs.Values[key.substr(std::string(P_RAW_APPLIED_KNOB).size())] = value;
+            continue;
+        }
+
         auto prop = ContainerProperties.find(key);
         if (prop != ContainerProperties.end()) {
 
@@ -1867,7 +2454,7 @@ TError TContainer::Restore(TScopedLock &holder_lock, const kv::TNode &node) {
             parent = parent->Parent;
         }
 
-        error = PrepareResources(nullptr);
+        error = PrepareResources(nullptr, true);
         if (error)
             goto error;
 
@@ -2020,6 +2607,13 @@ TCgroup TContainer::GetCgroup(const TSubsystem &subsystem) const {
     return subsystem.Cgroup(std::string(PORTO_ROOT_CGROUP) + "/" + GetName());
 }
 
+/* Writes into this cgroup skip values which are already applied */
+TCgroup TContainer::GetKnobCgroup(const TSubsystem &subsystem) {
+    TCgroup cg = GetCgroup(subsystem);
+    cg.Applied = &AppliedKnobs;
+    return cg;
+}
+
 void TContainer::ExitTree(TScopedLock &holder_lock, int status, bool oomKilled) {
 
     /* Detect fatal signals: portoinit cannot kill itself */
@@ -2152,9 +2746,80 @@ bool TContainer::HasOomReceived() {
     return read(OomEventFd.GetFd(), &val, sizeof(val)) == sizeof(val) && val != 0;
 }
 
+void TContainer::RecordOom() {
+    TOomEvent oom;
+
+    oom.Time = time(nullptr);
+    oom.Pid = Task ? Task->GetPid() : 0;
+    oom.Usage = 0;
+    oom.Limit = GetHierarchyMemLimit(nullptr);
+
+    if (!oom.Pid || TPath("/proc/" + std::to_string(oom.Pid) + "/comm").ReadAll(oom.Comm, 64))
+        oom.Comm = "";
+    oom.Comm = StringTrim(oom.Comm);
+    for (auto &c: oom.Comm)
+        if (isspace(c) || c == ';')
+            c = '_';
+    if (oom.Comm.empty())
+        oom.Comm = "-";
+
+    auto cg = GetCgroup(MemorySubsystem);
+    (void)MemorySubsystem.Usage(cg, oom.Usage);
+
+    L_EVT() << "OOM " << GetName() << " pid " << oom.Pid << " comm " << oom.Comm
+            << " usage " << oom.Usage << " limit " << oom.Limit << std::endl;
+
+    OomEvents.push_back(oom);
+    while (OomEvents.size() > config().container().max_oom_events())
+        OomEvents.pop_front();
+    PropMask |= OOM_EVENTS_SET;
+
+    CountOom();
+}
+
+void TContainer::CountOom() {
+    OomCount++;
+    PropMask |= OOM_COUNT_SET;
+    Statistics->ContainersOom++;
+}
+
 void TContainer::ScheduleRespawn() {
+    uint64_t delay = config().container().respawn_delay_ms();
+    uint64_t maxDelay = std::max(delay, (uint64_t)config().container().respawn_max_delay_ms());
+
+    /* container which lived long enough isn't crash-looping */
+    if (DeathTime >= StartTime + maxDelay)
+        RespawnAttempts = 0;
+
+    for (uint64_t i = 0; i < RespawnAttempts && delay < maxDelay; i++)
+        delay *= 2;
+    delay = std::min(delay, maxDelay);
+
+    /* spread containers failed at the same time */
+    if (delay > 1)
+        delay = delay / 2 + random() % (delay / 2 + 1);
+
+    RespawnAttempts++;
+    RespawnDelay = delay;
+
+    L() << "Respawn " << GetName() << " in " << delay << " ms, attempt "
+        << RespawnAttempts << std::endl;
+
     TEvent e(EEventType::Respawn, shared_from_this());
-    Holder->Queue->Add(config().container().respawn_delay_ms(), e);
+    e.Respawn.DeathTime = DeathTime;
+    Holder->Queue->Add(delay, e);
+}
+
+bool TContainer::ThrottleRespawn(const TEvent &event) {
+    uint64_t wait = StartRateLimit.Take(GetCurrentTimeMs());
+    if (!wait)
+        return false;
+
+    Statistics->RespawnThrottled++;
+    wait += random() % (wait + 1);
+
+    Holder->Queue->Add(wait, event);
+    return true;
 }
 
 TError TContainer::Respawn(TScopedLock &holder_lock) {
@@ -2170,6 +2835,7 @@ TError TContainer::Respawn(TScopedLock &holder_lock) {
     error = Start(nullptr, false);
     RespawnCount++;
     PropMask |= RESPAWN_COUNT_SET;
+    Statistics->Respawned++;
 
     if (error)
         return error;
@@ -2199,14 +2865,20 @@ void TContainer::DeliverEvent(TScopedLock &holder_lock, const TEvent &event) {
     switch (event.Type) {
         case EEventType::Exit:
             {
-                uint64_t failcnt = 0lu;
+                uint64_t failcnt = 0lu, oomKills = 0lu;
                 auto cg = GetCgroup(MemorySubsystem);
                 error = MemorySubsystem.GetFailCnt(cg, failcnt);
                 if (error)
                     L_WRN() << "Can't get container memory.failcnt" << std::endl;
 
-                ExitTree(holder_lock, event.Exit.Status,
-                         FdHasEvent(OomEventFd.GetFd()) || failcnt);
+                bool oomEvent = FdHasEvent(OomEventFd.GetFd());
+                (void)MemorySubsystem.GetOomKills(cg, oomKills);
+
+                /* Root task is already reaped: count OOM without details */
+                if (oomEvent || oomKills)
+                    CountOom();
+
+                ExitTree(holder_lock, event.Exit.Status, oomEvent || failcnt);
             }
             break;
         case EEventType::RotateLogs:
@@ -2222,6 +2894,16 @@ void TContainer::DeliverEvent(TScopedLock &holder_lock, const TEvent &event) {
             }
             break;
         case EEventType::Respawn:
+            /* Container could be restarted, destroyed or reconfigured while
+               event was waiting, event for earlier death is stale too */
+            if (!MayRespawn() || event.Respawn.DeathTime != DeathTime) {
+                L() << "Skip stale respawn of " << GetName() << std::endl;
+                break;
+            }
+            if (ThrottleRespawn(event)) {
+                L() << "Respawn " << GetName() << " throttled" << std::endl;
+                break;
+            }
             error = Respawn(holder_lock);
             if (error)
                 L_WRN() << "Can't respawn container: " << error << std::endl;
@@ -2229,6 +2911,8 @@ void TContainer::DeliverEvent(TScopedLock &holder_lock, const TEvent &event) {
                 L() << "Respawned " << GetName() << std::endl;
             break;
         case EEventType::OOM:
+            /* Tasks are still alive, take snapshot before killing them */
+            RecordOom();
             ExitTree(holder_lock, SIGKILL, true);
             break;
         default:
@@ -2298,6 +2982,47 @@ TError TContainer::UpdateTrafficClasses() {
     return TError::Success();
 }
 
+TError TContainer::UpdateIngressLimits() {
+    std::map<std::string, std::pair<int, int>> links;
+    std::map<std::string, int> peers;
+    TError error, result;
+
+    /* Only own network namespace has dedicated links to shape */
+    if (!Net || !Parent || !Parent->Net || Net == Parent->Net)
+        return TError::Success();
+
+    {
+        auto net_lock = Net->ScopedLock();
+        error = Net->GetVethLinks(links);
+        if (error)
+            return error;
+    }
+
+    auto parent_lock = Parent->Net->ScopedLock();
+    error = Parent->Net->GetVethPeers(links, peers);
+    if (error)
+        return error;
+
+    for (auto &i: NetRxLimit) {
+        if (i.first != "default" && peers.find(i.first) == peers.end())
+            L_WRN() << "Interface " << i.first << " is not veth or not found" << std::endl;
+    }
+
+    for (auto &peer: peers) {
+        auto it = NetRxLimit.find(peer.first);
+        uint64_t limit = it != NetRxLimit.end() ? it->second : NetRxLimit["default"];
+
+        error = Parent->Net->SetIngressLimit(peer.second, limit);
+        if (error) {
+            L_WRN() << "Cannot set ingress limit " << peer.first << " " << error << std::endl;
+            if (!result)
+                result = error;
+        }
+    }
+
+    return result;
+}
+
 TContainerWaiter::TContainerWaiter(std::shared_ptr<TClient> client,
                                    std::function<void (std::shared_ptr<TClient>,
                                                        TError, std::string)> callback) :
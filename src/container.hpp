@@ -3,11 +3,13 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <deque>
 #include <memory>
 
 #include "util/unix.hpp"
 #include "util/locks.hpp"
 #include "util/log.hpp"
+#include "util/ratelimit.hpp"
 #include "stream.hpp"
 #include "cgroup.hpp"
 #include "task.hpp"
@@ -29,6 +31,7 @@ class TContainerWaiter;
 class TClient;
 class TVolume;
 class TVolumeHolder;
+struct TQueuedRequest;
 
 namespace kv {
     class TNode;
@@ -47,6 +50,19 @@ enum class EContainerState {
 
 class TProperty;
 
+constexpr const char *CHECKPOINT_SPEC = "porto.spec";
+
+/* name and duration in ms of each step of checkpoint or restore */
+typedef std::vector<std::pair<std::string, uint64_t>> TCheckpointPhases;
+
+struct TOomEvent {
+    uint64_t Time;          // unix time
+    pid_t Pid;              // container root task
+    std::string Comm;
+    uint64_t Usage;
+    uint64_t Limit;         // hierarchical, 0 - unlimited
+};
+
 class TContainer : public std::enable_shared_from_this<TContainer>,
                    public TNonCopyable,
                    public TLockable {
@@ -57,13 +73,28 @@ class TContainer : public std::enable_shared_from_this<TContainer>,
     const std::shared_ptr<TContainer> Parent;
     std::shared_ptr<TKeyValueStorage> Storage;
     int Acquired = 0;
+    int AcquiredChildren = 0; // acquired descendants, changed under holder lock
     int Id;
     TScopedFd OomEventFd;
+    TKnobCache AppliedKnobs; // dynamic properties written into cgroups
     size_t CgroupEmptySince = 0;
     size_t RunningChildren = 0; // changed under holder lock
+
+    // hierarchical memory aggregates, changed under holder lock
+    bool HierarchyLinked = false;           // accounted in parent
+    uint64_t HierarchyMemGuarantee = 0;     // max(own, children sum)
+    uint64_t ChildrenMemGuarantee = 0;
+    uint64_t SubtreeMemLimit = 0;           // 0 - unlimited
+    uint64_t ChildrenMemLimit = 0;          // sum of limited children
+    size_t UnlimitedChildren = 0;
     bool LostAndRestored = false;
     std::list<std::weak_ptr<TContainerWaiter>> Waiters;
 
+    // property values at last commit, for readers of busy container
+    std::shared_ptr<const std::map<std::string, std::string>> Snapshot;
+    TError ApplyProperty(const std::string &property, const std::string &value,
+                         std::shared_ptr<TClient> &client);
+
     std::shared_ptr<TEpollSource> Source;
     bool IsMeta = false;
 
@@ -81,7 +112,7 @@ class TContainer : public std::enable_shared_from_this<TContainer>,
     TError PrepareOomMonitor();
     TError PrepareLoop();
     void ShutdownOom();
-    TError PrepareCgroups();
+    TError PrepareCgroups(bool restore);
     TError ConfigureDevices(std::vector<TDevice> &devices);
     TError ParseNetConfig(struct TNetCfg &NetCfg);
     TError PrepareNetwork(struct TNetCfg &NetCfg);
@@ -92,9 +123,10 @@ class TContainer : public std::enable_shared_from_this<TContainer>,
 
     const std::string StripParentName(const std::string &name) const;
     void ScheduleRespawn();
+    bool ThrottleRespawn(const TEvent &event);
     TError Respawn(TScopedLock &holder_lock);
     void StopChildren(TScopedLock &holder_lock);
-    TError PrepareResources(std::shared_ptr<TClient> client);
+    TError PrepareResources(std::shared_ptr<TClient> client, bool restore = false);
     void FreeResources();
 
     void RestoreStdPath(const std::string &property,
@@ -122,6 +154,8 @@ class TContainer : public std::enable_shared_from_this<TContainer>,
     TError Unfreeze(TScopedLock &holder_lock);
     TError Freeze(TScopedLock &holder_lock);
 
+    TError RestoreTask();
+
 public:
     uint64_t PropMask;
     TCred OwnerCred;
@@ -157,32 +191,44 @@ public:
     std::string NsName;
     uint64_t StdoutLimit;
     uint64_t MemLimit;
+    uint64_t MemHighLimit;
     uint64_t AnonMemLimit;
     uint64_t DirtyMemLimit;
+    uint64_t ThreadLimit;
     bool RechargeOnPgfault;
     std::string CpuPolicy;
     double CpuLimit;
     double CpuGuarantee;
     std::string IoPolicy;
+    TUintMap IoWeight;
     uint64_t IoLimit;
     uint64_t IopsLimit;
     TUintMap NetGuarantee;
     TUintMap NetLimit;
+    TUintMap NetRxLimit;
     TUintMap NetPriority;
     bool ToRespawn;
     int MaxRespawns;
     uint64_t RespawnCount;
+    uint64_t RespawnAttempts = 0;
+    uint64_t RespawnDelay = 0;
     std::string Private;
     uint64_t AgingTime;
     bool PortoEnabled;
     bool IsWeak;
     EContainerState State = EContainerState::Unknown;
     bool OomKilled;
+    uint64_t OomCount = 0;
+    std::deque<TOomEvent> OomEvents;    // bounded by max_oom_events
     int ExitStatus;
     int TaskStartErrno = -1;
     uint64_t StdoutOffset;
     uint64_t StderrOffset;
 
+    /* next start restores tasks from this checkpoint image */
+    TPath RestoreImage;
+    std::vector<int> RestorePids;
+
     // TODO: make private
     std::unique_ptr<TTask> Task;
     std::shared_ptr<TNetwork> Net;
@@ -209,6 +255,17 @@ public:
     void Release();
     bool IsAcquired() const;
 
+    // requests blocked by acquired container, changed under holder lock,
+    // entry stays queued until executed, new requests are queued behind
+    std::list<TQueuedRequest> QueuedRequests;
+    bool QueueDispatched = false;
+    void PushQueuedRequest(const TQueuedRequest &request);
+    std::list<TQueuedRequest>::iterator
+        EraseQueuedRequest(std::list<TQueuedRequest>::iterator it);
+    bool HasAcquiredChild() const;
+    void ScheduleQueuedRequests();
+    void DispatchQueuedRequests();
+
     void SanitizeCapabilities();
 
     const std::string GetName() const;
@@ -217,6 +274,10 @@ public:
     const int GetLevel() const { return Level; }
     uint64_t GetHierarchyMemGuarantee(void) const;
     uint64_t GetHierarchyMemLimit(std::shared_ptr<const TContainer> root) const;
+    /* Propagates changes of memory guarantee, limit or state to ancestors */
+    void UpdateHierarchy();
+    /* Recomputes aggregates from scratch, fixes and counts mismatches */
+    int VerifyHierarchy();
 
     bool IsRoot() const;
     bool IsPortoRoot() const;
@@ -242,15 +303,25 @@ public:
     TError Resume(TScopedLock &holder_lock);
     TError Kill(int sig);
 
+    TError Checkpoint(TScopedLock &holder_lock, const TPath &dir,
+                      TCheckpointPhases &phases);
+    static TError ReadCheckpoint(const TPath &dir, std::string &name, std::vector<int> &pids,
+                                 std::vector<std::pair<std::string, std::string>> &properties);
+
     TError GetProperty(const std::string &property, std::string &value,
                        std::shared_ptr<TClient> &client) const;
+    TError GetSnapshotProperty(const std::string &property, std::string &value) const;
     TError SetProperty(const std::string &property, const std::string &value,
                        std::shared_ptr<TClient> &client);
+    /* Applies all properties and saves once, stops at first error */
+    TError SetProperties(const std::vector<std::pair<std::string, std::string>> &properties,
+                         std::shared_ptr<TClient> &client);
 
     TError Restore(TScopedLock &holder_lock, const kv::TNode &node);
     TError Save(void);
 
     TCgroup GetCgroup(const TSubsystem &subsystem) const;
+    TCgroup GetKnobCgroup(const TSubsystem &subsystem);
     bool CanRemoveDead() const;
     std::vector<std::string> GetChildren();
     std::shared_ptr<TContainer> FindRunningParent() const;
@@ -267,11 +338,14 @@ public:
     void SyncStateWithCgroup(TScopedLock &holder_lock);
     void CleanupExpiredChildren();
     TError UpdateTrafficClasses();
+    TError UpdateIngressLimits();
 
     bool MayExit(int pid);
     bool MayRespawn();
     bool MayReceiveOom(int fd);
     bool HasOomReceived();
+    void RecordOom();
+    void CountOom();
 
     bool IsFrozen();
     bool IsValid();
@@ -325,6 +399,7 @@ public:
 };
 
 extern std::mutex ContainersMutex;
+extern TTokenBucket StartRateLimit;
 extern std::map<std::string, std::shared_ptr<TContainer>> Containers;
 
 static inline std::unique_lock<std::mutex> LockContainers() {
@@ -1,4 +1,8 @@
+#include <map>
+#include <algorithm>
+
 #include "device.hpp"
+#include "config.hpp"
 
 extern "C" {
 #include <sys/stat.h>
@@ -182,3 +186,79 @@ TError TDevice::Makedev(const TPath &root) const {
 
     return TError::Success();
 }
+
+TError TDeviceRules::Permitted(const TCred &cred) const {
+    for (size_t i = 0; i < Devices.size(); i++) {
+        TError error = Devices[i].Permitted(cred);
+        if (error)
+            return TError(error, "device: " + Config[i]);
+    }
+
+    return TError::Success();
+}
+
+static std::mutex DeviceCacheMutex;
+static std::map<std::string, std::shared_ptr<TDeviceRules>> DeviceCache;
+
+TError CompileDevices(const std::vector<std::string> &config,
+                      std::shared_ptr<TDeviceRules> &rules) {
+    uint64_t now = GetCurrentTimeMs();
+    uint64_t ttl = ::config().container().device_cache_ms();
+    std::string key = CommaSeparatedList(config, "\n");
+
+    {
+        std::lock_guard<std::mutex> lock(DeviceCacheMutex);
+        auto it = DeviceCache.find(key);
+        if (it != DeviceCache.end() && now - it->second->Compiled < ttl) {
+            rules = it->second;
+            return TError::Success();
+        }
+    }
+
+    auto compiled = std::make_shared<TDeviceRules>();
+    compiled->Config = config;
+    compiled->Compiled = now;
+
+    for (auto &cfg: config) {
+        TDevice device;
+        TError error = device.Parse(cfg);
+        if (error)
+            return TError(error, "device: " + cfg);
+        compiled->Devices.push_back(device);
+    }
+
+    /*
+     * Cgroup removes only exceptions with exactly the same device,
+     * so after dropping overridden entries allow and deny rules
+     * commute and could be written in two batches.
+     */
+    std::set<std::string> seen;
+    for (auto dev = compiled->Devices.rbegin();
+            dev != compiled->Devices.rend(); dev++) {
+        std::string allow = dev->CgroupRule(true);
+        std::string deny = dev->CgroupRule(false);
+        std::string rule = allow != "" ? allow : deny;
+
+        if (!seen.insert(rule.substr(0, rule.rfind(' '))).second)
+            continue;
+        if (allow != "")
+            compiled->Allow.push_back(allow);
+        if (deny != "")
+            compiled->Deny.push_back(deny);
+    }
+    std::reverse(compiled->Allow.begin(), compiled->Allow.end());
+    std::reverse(compiled->Deny.begin(), compiled->Deny.end());
+
+    std::lock_guard<std::mutex> lock(DeviceCacheMutex);
+    for (auto it = DeviceCache.begin(); it != DeviceCache.end(); ) {
+        if (now - it->second->Compiled >= ttl)
+            it = DeviceCache.erase(it);
+        else
+            it++;
+    }
+    if (ttl)
+        DeviceCache[key] = compiled;
+    rules = compiled;
+
+    return TError::Success();
+}
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <memory>
 #include "util/path.hpp"
 #include "util/cred.hpp"
+#include "util/unix.hpp"
 
 struct TDevice {
     TPath Path;
@@ -23,3 +28,25 @@ struct TDevice {
     TError Permitted(const TCred &cred) const;
     TError Makedev(const TPath &root) const;
 };
+
+/*
+ * Devices and cgroup rules compiled from one device configuration,
+ * shared by containers with the same configuration.
+ */
+struct TDeviceRules : public TNonCopyable {
+    std::vector<std::string> Config;
+    std::vector<TDevice> Devices;
+    std::vector<std::string> Allow;
+    std::vector<std::string> Deny;
+    uint64_t Compiled = 0;
+
+    std::mutex Mutex;
+    TScopedFd Program; /* cgroup v2 device filter, loaded at first use */
+    TScopedFd DenyProgram; /* same for not restricted container, only denies */
+
+    /* access depends on node permissions and owner groups, never cached */
+    TError Permitted(const TCred &cred) const;
+};
+
+TError CompileDevices(const std::vector<std::string> &config,
+                      std::shared_ptr<TDeviceRules> &rules);
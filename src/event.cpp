@@ -57,12 +57,18 @@ std::string TEvent::GetMsg() const {
             return "OOM killed with fd " + std::to_string(OOM.Fd);
         case EEventType::CgroupSync:
             return "cgroup sync";
+        case EEventType::CgroupReconcile:
+            return "cgroup reconcile";
+        case EEventType::CgroupRepair:
+            return "cgroup repair " + CgroupRepair.Cgroup.Name;
         case EEventType::WaitTimeout:
             return "wait timeout";
         case EEventType::UpdateNetwork:
             return "update network";
         case EEventType::DestroyWeak:
             return "destroy weak";
+        case EEventType::RequestTimeout:
+            return "request timeout";
         default:
             return "unknown event";
     }
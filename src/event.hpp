@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "util/worker.hpp"
+#include "cgroup.hpp"
 
 class TContainer;
 class TContainerHolder;
@@ -15,9 +16,12 @@ enum class EEventType {
     Respawn,
     OOM,
     CgroupSync,
+    CgroupReconcile,
+    CgroupRepair,
     WaitTimeout,
     UpdateNetwork,
     DestroyWeak,
+    RequestTimeout,
 };
 
 class TEventWorker;
@@ -36,10 +40,18 @@ public:
         int Fd;
     } OOM;
 
+    struct {
+        uint64_t DeathTime = 0;
+    } Respawn;
+
     struct {
         std::weak_ptr<TContainerWaiter> Waiter;
     } WaitTimeout;
 
+    struct {
+        TCgroup Cgroup;
+    } CgroupRepair;
+
     uint64_t DueMs = 0;
 
     TEvent(EEventType type, std::shared_ptr<TContainer> container = nullptr) :
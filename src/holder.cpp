@@ -7,6 +7,7 @@
 #include "property.hpp"
 #include "event.hpp"
 #include "client.hpp"
+#include "rpc.hpp"
 #include "task.hpp"
 #include "cgroup.hpp"
 #include "network.hpp"
@@ -76,6 +77,23 @@ TError TContainerHolder::CreatePortoRoot(TScopedLock &holder_lock) {
     Statistics->RemoveDead = 0;
     Statistics->Rotated = 0;
     Statistics->Started = 0;
+    Statistics->Respawned = 0;
+    Statistics->RespawnThrottled = 0;
+    Statistics->QueuedRequests = 0;
+    Statistics->QueueTimeouts = 0;
+    Statistics->ReconcilePasses = 0;
+    Statistics->CgroupDiscrepancies = 0;
+    Statistics->CgroupRepairs = 0;
+    Statistics->HierarchyMismatches = 0;
+    Statistics->CgroupWritesSkipped = 0;
+    Statistics->RequestsThrottled = 0;
+    Statistics->ContainersOom = 0;
+    Statistics->Checkpoints = 0;
+    Statistics->Restores = 0;
+
+    StartRateLimit.Configure(config().container().start_rate(),
+                             config().container().start_burst(),
+                             GetCurrentTimeMs());
 
     return TError::Success();
 }
@@ -159,6 +177,9 @@ TError TContainerHolder::Create(TScopedLock &holder_lock, const std::string &nam
     if (Containers.find(name) != Containers.end())
         return TError(EError::ContainerAlreadyExists, "container " + name + " already exists");
 
+    if (RepairingNames.count(name))
+        return TError(EError::Busy, "leftover cgroups of " + name + " are being removed");
+
     if (Containers.size() + 1 > config().container().max_total())
         return TError(EError::ResourceNotAvailable, "number of created containers exceeds limit");
 
@@ -296,16 +317,20 @@ void TContainerHolder::Unlink(TScopedLock &holder_lock, std::shared_ptr<TContain
     PORTO_ASSERT(!error);
     Containers.erase(c->GetName());
     Statistics->Created--;
+
+    c->DispatchQueuedRequests();
 }
 
-std::vector<std::shared_ptr<TContainer> > TContainerHolder::List(bool all) const {
+std::vector<std::shared_ptr<TContainer> > TContainerHolder::List(bool all,
+                                                                 const std::string &prefix) const {
     std::vector<std::shared_ptr<TContainer> > ret;
 
-    for (auto c : Containers) {
-        PORTO_ASSERT(c.first == c.second->GetName());
-        if (!all && c.second->IsPortoRoot())
+    for (auto it = Containers.lower_bound(prefix); it != Containers.end() &&
+            !it->first.compare(0, prefix.size(), prefix); it++) {
+        PORTO_ASSERT(it->first == it->second->GetName());
+        if (!all && it->second->IsPortoRoot())
             continue;
-        ret.push_back(c.second);
+        ret.push_back(it->second);
     }
 
     return ret;
@@ -408,15 +433,6 @@ bool TContainerHolder::RestoreFromStorage() {
             node->Remove();
     }
 
-    if (restored) {
-        for (auto &c: Containers) {
-            if (c.second->IsLostAndRestored()) {
-                ScheduleCgroupSync();
-                break;
-            }
-        }
-    }
-
     return restored;
 }
 
@@ -452,24 +468,14 @@ TError TContainerHolder::Restore(TScopedLock &holder_lock, const std::string &na
 }
 
 void TContainerHolder::RemoveLeftovers() {
-    TError error;
+    /* cgroups are cleaned up by reconciler in background */
+    Statistics->ReconcileSynced = GetCurrentTimeMs();
+    ScheduleReconcile(0);
 
-    for (auto hy: Hierarchies) {
-        std::vector<TCgroup> cgroups;
-
-        error = hy->Cgroup(PORTO_ROOT_CGROUP).ChildsAll(cgroups);
-        if (error)
-            L_ERR() << "Cannot dump porto " << hy->Type << " cgroups : "
-                    << error << std::endl;
-
-        for (auto cg = cgroups.rbegin(); cg != cgroups.rend(); cg++) {
-            std::string name = cg->Name.substr(strlen(PORTO_ROOT_CGROUP) + 1);
-            if (Containers.count(name))
-                continue;
-
-            if (!cg->IsEmpty())
-                (void)cg->KillAll(9);
-            (void)cg->Remove();
+    for (auto &it: Containers) {
+        if (it.second->IsLostAndRestored()) {
+            ScheduleCgroupSync();
+            break;
         }
     }
 
@@ -488,9 +494,123 @@ void TContainerHolder::ScheduleLogRotatation() {
     Queue->Add(config().daemon().rotate_logs_timeout_s() * 1000, e);
 }
 
+/* Lost containers are checked at fixed period, reconciler walk backs off */
 void TContainerHolder::ScheduleCgroupSync() {
     TEvent e(EEventType::CgroupSync);
-    Queue->Add(5000, e);
+    Queue->Add(config().daemon().cgroup_reconcile_lost_period_ms(), e);
+}
+
+void TContainerHolder::ScheduleReconcile(uint64_t delayMs) {
+    TEvent e(EEventType::CgroupReconcile);
+    Queue->Add(delayMs, e);
+}
+
+/*
+ * Walks porto cgroups breadth-first in time slices without holder lock,
+ * compares them with containers and queues repairs as separate events.
+ */
+void TContainerHolder::Reconcile() {
+    uint64_t start = GetCurrentTimeMs();
+    uint64_t slice = config().daemon().cgroup_reconcile_slice_ms();
+    std::vector<TCgroup> batch;
+
+    if (ReconcileQueue.empty()) {
+        ReconcilePassStart = start;
+        ReconcileLost = false;
+        ReconcileFound = false;
+        for (auto hy: Hierarchies) {
+            TCgroup cg = hy->Cgroup(PORTO_ROOT_CGROUP);
+            TError error = cg.Childs(batch);
+            if (error)
+                L_ERR() << "Cannot list " << cg << " : " << error << std::endl;
+        }
+    }
+
+    do {
+        if (!ReconcileQueue.empty()) {
+            TCgroup cg = ReconcileQueue.front();
+            ReconcileQueue.pop_front();
+            (void)cg.Childs(batch); /* might be already removed */
+        }
+
+        {
+            auto holder_lock = LockContainers();
+
+            for (auto &cg : batch) {
+                std::string name = cg.Name.substr(strlen(PORTO_ROOT_CGROUP) + 1);
+                auto it = Containers.find(name);
+
+                if (it == Containers.end()) {
+                    /* subtree is removed by repair, don't descend */
+                    L_WRN() << "Found leftover cgroup " << cg << std::endl;
+                    Statistics->CgroupDiscrepancies++;
+                    ReconcileFound = true;
+                    TEvent e(EEventType::CgroupRepair);
+                    e.CgroupRepair.Cgroup = cg;
+                    Queue->Add(0, e);
+                    continue;
+                }
+
+                // LostAndRestored is never changed after startup
+                if (it->second->IsLostAndRestored() &&
+                        it->second->GetState() == EContainerState::Running)
+                    ReconcileLost = true;
+
+                ReconcileQueue.push_back(cg);
+            }
+        }
+
+        batch.clear();
+    } while (!ReconcileQueue.empty() && GetCurrentTimeMs() - start < slice);
+
+    if (!ReconcileQueue.empty()) {
+        ScheduleReconcile(slice);
+        return;
+    }
+
+    Statistics->ReconcilePasses++;
+    Statistics->ReconcileSynced = ReconcilePassStart;
+
+    /* self-check for incrementally maintained aggregates, full walk under lock */
+    uint64_t verifyPeriod = config().daemon().hierarchy_verify_period_ms();
+    if (verifyPeriod && GetCurrentTimeMs() - HierarchyVerified >= verifyPeriod) {
+        auto holder_lock = LockContainers();
+        auto it = Containers.find(ROOT_CONTAINER);
+        if (it != Containers.end())
+            Statistics->HierarchyMismatches += it->second->VerifyHierarchy();
+        HierarchyVerified = GetCurrentTimeMs();
+    }
+
+    if (ReconcileFound)
+        ReconcileIdlePasses = 0;
+    else
+        ReconcileIdlePasses++;
+
+    /* walk more often while lost containers run, back off while all is fine */
+    uint64_t period = config().daemon().cgroup_reconcile_period_ms();
+    if (ReconcileLost) {
+        uint64_t lost = config().daemon().cgroup_reconcile_lost_period_ms();
+        for (uint64_t i = 0; i < ReconcileIdlePasses && lost < period; i++)
+            lost *= 2;
+        period = std::min(lost, period);
+    }
+    ScheduleReconcile(period);
+}
+
+void TContainerHolder::RepairCgroup(TScopedLock &holder_lock, const TCgroup &cg) {
+    std::string name = cg.Name.substr(strlen(PORTO_ROOT_CGROUP) + 1);
+
+    if (Containers.count(name) || RepairingNames.count(name))
+        return;
+
+    /* name is reserved, so nobody could create container there meanwhile */
+    RepairingNames.insert(name);
+    holder_lock.unlock();
+    (void)cg.RemoveSubtree();
+    holder_lock.lock();
+    RepairingNames.erase(name);
+
+    Statistics->CgroupRepairs++;
 }
 
 bool TContainerHolder::DeliverEvent(const TEvent &event) {
@@ -499,6 +619,11 @@ bool TContainerHolder::DeliverEvent(const TEvent &event) {
 
     bool delivered = false;
 
+    if (event.Type == EEventType::CgroupReconcile) {
+        Reconcile();
+        return true;
+    }
+
     auto holder_lock = LockContainers();
 
     switch (event.Type) {
@@ -570,24 +695,33 @@ bool TContainerHolder::DeliverEvent(const TEvent &event) {
         for (auto &target : list) {
             // don't lock container here, LostAndRestored is never changed
             // after startup
-            if (target->IsLostAndRestored())
-                rearm = true;
+            if (!target->IsLostAndRestored())
+                continue;
 
-            if (target->IsAcquired())
+            if (target->IsAcquired()) {
+                rearm = true;
                 continue;
+            }
 
             TNestedScopedLock lock(*target, holder_lock);
-            if (target->IsValid() && target->IsLostAndRestored()) {
-                if (target->IsAcquired())
-                    continue;
+            if (target->IsValid() && !target->IsAcquired()) {
                 target->SyncStateWithCgroup(holder_lock);
-            }
+                if (target->GetState() == EContainerState::Running)
+                    rearm = true;
+            } else if (target->IsValid())
+                rearm = true;
         }
         if (rearm)
             ScheduleCgroupSync();
         delivered = true;
         break;
     }
+    case EEventType::CgroupRepair:
+    {
+        RepairCgroup(holder_lock, event.CgroupRepair.Cgroup);
+        delivered = true;
+        break;
+    }
     case EEventType::WaitTimeout:
     {
         auto w = event.WaitTimeout.Waiter.lock();
@@ -596,6 +730,14 @@ bool TContainerHolder::DeliverEvent(const TEvent &event) {
         delivered = true;
         break;
     }
+    case EEventType::RequestTimeout:
+    {
+        auto container = event.Container.lock();
+        if (container)
+            ExpireQueuedRequests(container);
+        delivered = true;
+        break;
+    }
     case EEventType::DestroyWeak:
     {
         auto container = event.Container.lock();
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <map>
+#include <set>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -10,6 +12,7 @@
 #include "util/idmap.hpp"
 #include "util/cred.hpp"
 #include "util/locks.hpp"
+#include "cgroup.hpp"
 
 class TContainer;
 class TIdMap;
@@ -33,6 +36,18 @@ class TContainerHolder : public std::enable_shared_from_this<TContainerHolder> {
     TError RestoreId(const kv::TNode &node, int &id);
     void ScheduleLogRotatation();
     void ScheduleCgroupSync();
+
+    /* Incremental cgroup reconciler, touched only by its event */
+    std::deque<TCgroup> ReconcileQueue;
+    uint64_t ReconcilePassStart = 0;
+    bool ReconcileLost = false;
+    bool ReconcileFound = false; /* current pass found discrepancies */
+    uint64_t ReconcileIdlePasses = 0; /* passes in row which found nothing */
+    uint64_t HierarchyVerified = 0;
+    void ScheduleReconcile(uint64_t delayMs);
+    void Reconcile();
+    void RepairCgroup(TScopedLock &holder_lock, const TCgroup &cg);
+    std::set<std::string> RepairingNames; /* under holder lock */
     std::map<std::string, std::shared_ptr<TKeyValueNode>>
         SortNodes(const std::vector<std::shared_ptr<TKeyValueNode>> &nodes);
     void Unlink(TScopedLock &holder_lock, std::shared_ptr<TContainer> c);
@@ -40,6 +55,7 @@ class TContainerHolder : public std::enable_shared_from_this<TContainerHolder> {
 public:
     std::shared_ptr<TEventQueue> Queue = nullptr;
     std::shared_ptr<TEpollLoop> EpollLoop;
+    size_t QueuedRequests = 0; /* in queues of all containers, under holder lock */
 
     TContainerHolder(std::shared_ptr<TEpollLoop> epollLoop,
                      std::shared_ptr<TKeyValueStorage> storage) :
@@ -66,7 +82,9 @@ public:
     TError Destroy(TScopedLock &holder_lock, std::shared_ptr<TContainer> c);
     void DestroyRoot(TScopedLock &holder_lock);
 
-    std::vector<std::shared_ptr<TContainer> > List(bool all = false) const;
+    /* Names are sorted, containers with common prefix are listed by range */
+    std::vector<std::shared_ptr<TContainer> > List(bool all = false,
+                                                   const std::string &prefix = "") const;
 
     bool DeliverEvent(const TEvent &event);
 };
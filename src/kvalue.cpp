@@ -119,6 +119,9 @@ TError TKeyValueStorage::MountTmpfs(std::string size) {
         }
     }
 
+    if (config.Simulate())
+        return TError::Success();
+
     error = mount.Find(Root);
     if (error || mount.GetMountpoint() != Root) {
         error = Root.Mount("tmpfs", "tmpfs",
@@ -187,6 +190,8 @@ TError TKeyValueStorage::Dump() {
 }
 
 TError TKeyValueStorage::Destroy() {
+    if (config.Simulate())
+        return Root.ClearDirectory();
     return Root.Umount(UMOUNT_NOFOLLOW);
 }
 
@@ -616,6 +616,8 @@ TError TNetwork::GetTrafficCounters(int minor, ETclassStat stat,
     case ETclassStat::RxPackets:
     case ETclassStat::RxDrops:
         return GetInterfaceCounters(stat, result);
+    case ETclassStat::RxOverlimits:
+        return TError::Success();
     default:
         return TError(EError::Unknown, "Unsupported netlink statistics");
     }
@@ -772,6 +774,146 @@ out:
     return error;
 }
 
+/* Lists veth links of this namespace as name -> (ifindex, peer ifindex) */
+TError TNetwork::GetVethLinks(std::map<std::string, std::pair<int, int>> &links) {
+    struct nl_cache *cache;
+
+    int ret = rtnl_link_alloc_cache(GetSock(), AF_UNSPEC, &cache);
+    if (ret < 0)
+        return Nl->Error(ret, "Cannot allocate link cache");
+
+    for (auto obj = nl_cache_get_first(cache); obj; obj = nl_cache_get_next(obj)) {
+        auto link = (struct rtnl_link *)obj;
+        std::string type = rtnl_link_get_type(link) ?: "";
+        int peer = rtnl_link_get_link(link);
+
+        std::string name = rtnl_link_get_name(link);
+
+        /* Skip host side peers of nested containers */
+        if (StringStartsWith(name, "portove-") || StringStartsWith(name, "L3-"))
+            continue;
+
+        if (type == "veth" && peer > 0)
+            links[name] = std::make_pair(
+                    rtnl_link_get_ifindex(link), peer);
+    }
+
+    nl_cache_free(cache);
+    return TError::Success();
+}
+
+/*
+ * Maps veth links of nested network to ifindex of their peers in this one.
+ * Peer index is relative to namespace of peer, thus accept only porto
+ * "portove-" and "L3-" links which point back to the same veth.
+ */
+TError TNetwork::GetVethPeers(const std::map<std::string, std::pair<int, int>> &links,
+                              std::map<std::string, int> &peers) {
+    struct nl_cache *cache;
+
+    int ret = rtnl_link_alloc_cache(GetSock(), AF_UNSPEC, &cache);
+    if (ret < 0)
+        return Nl->Error(ret, "Cannot allocate link cache");
+
+    for (auto &it: links) {
+        auto link = rtnl_link_get(cache, it.second.second);
+        if (!link)
+            continue;
+
+        std::string name = rtnl_link_get_name(link);
+        std::string type = rtnl_link_get_type(link) ?: "";
+
+        if (type == "veth" && rtnl_link_get_link(link) == it.second.first &&
+                (StringStartsWith(name, "portove-") ||
+                 StringStartsWith(name, "L3-")))
+            peers[it.first] = it.second.second;
+
+        rtnl_link_put(link);
+    }
+
+    nl_cache_free(cache);
+    return TError::Success();
+}
+
+/*
+ * Ingress traffic of container is egress traffic of host side peer,
+ * shape it with single htb class which catches all packets.
+ */
+TError TNetwork::SetIngressLimit(int ifIndex, uint64_t limit) {
+    struct nl_cache *cache;
+    struct rtnl_link *link;
+    TError error;
+
+    int ret = rtnl_link_alloc_cache(GetSock(), AF_UNSPEC, &cache);
+    if (ret < 0)
+        return Nl->Error(ret, "Cannot allocate link cache");
+
+    link = rtnl_link_get(cache, ifIndex);
+    nl_cache_free(cache);
+    if (!link)
+        return TError(EError::Unknown, "Cannot find peer link " + std::to_string(ifIndex));
+
+    TNlLink peer(Nl, link);
+    rtnl_link_put(link);
+
+    /* Never touch qdisc of links which porto hasn't created for container */
+    if (!StringStartsWith(peer.GetName(), "portove-") &&
+            !StringStartsWith(peer.GetName(), "L3-"))
+        return TError(EError::Unknown, "Link " + peer.GetName() +
+                      " is not container veth peer");
+
+    TNlHtb qdisc(TC_H_ROOT, TC_HANDLE(ROOT_TC_MAJOR, ROOT_TC_MINOR));
+
+    if (!limit) {
+        if (qdisc.Exists(peer))
+            return qdisc.Remove(peer);
+        return TError::Success();
+    }
+
+    if (!qdisc.Valid(peer, TC_HANDLE(ROOT_TC_MAJOR, DEFAULT_TC_MINOR))) {
+        (void)qdisc.Remove(peer);
+        error = qdisc.Create(peer, TC_HANDLE(ROOT_TC_MAJOR, DEFAULT_TC_MINOR));
+        if (error)
+            return error;
+    }
+
+    return AddTrafficClass(ifIndex, TC_HANDLE(ROOT_TC_MAJOR, ROOT_TC_MINOR),
+                           TC_HANDLE(ROOT_TC_MAJOR, DEFAULT_TC_MINOR),
+                           NET_DEFAULT_PRIO, limit, limit);
+}
+
+TError TNetwork::GetIngressCounter(int ifIndex, ETclassStat stat, uint64_t &value) {
+    struct nl_cache *cache;
+    struct rtnl_class *cls;
+    rtnl_tc_stat rtnlStat;
+
+    switch (stat) {
+    case ETclassStat::RxDrops:
+        rtnlStat = RTNL_TC_DROPS;
+        break;
+    case ETclassStat::RxOverlimits:
+        rtnlStat = RTNL_TC_OVERLIMITS;
+        break;
+    default:
+        return TError(EError::Unknown, "Unsupported netlink statistics");
+    }
+
+    value = 0;
+
+    int ret = rtnl_class_alloc_cache(GetSock(), ifIndex, &cache);
+    if (ret < 0)
+        return Nl->Error(ret, "Cannot allocate class cache");
+
+    cls = rtnl_class_get(cache, ifIndex, TC_HANDLE(ROOT_TC_MAJOR, DEFAULT_TC_MINOR));
+    if (cls) {
+        value = rtnl_tc_get_stat(TC_CAST(cls), rtnlStat);
+        rtnl_class_put(cls);
+    }
+
+    nl_cache_free(cache);
+    return TError::Success();
+}
+
 TError TNetwork::UpdateTrafficClasses(int parent, int minor,
         std::map<std::string, uint64_t> &Prio,
         std::map<std::string, uint64_t> &Rate,
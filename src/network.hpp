@@ -74,6 +74,12 @@ public:
                            uint64_t prio, uint64_t rate, uint64_t ceil);
     TError DelTrafficClass(int ifIndex, uint32_t handle);
 
+    TError GetVethLinks(std::map<std::string, std::pair<int, int>> &links);
+    TError GetVethPeers(const std::map<std::string, std::pair<int, int>> &links,
+                        std::map<std::string, int> &peers);
+    TError SetIngressLimit(int ifIndex, uint64_t limit);
+    TError GetIngressCounter(int ifIndex, ETclassStat stat, uint64_t &value);
+
     TError GetGateAddress(std::vector<TNlAddr> addrs,
                           TNlAddr &gate4, TNlAddr &gate6, int &mtu);
     TError AddAnnounce(const TNlAddr &addr, std::string master);
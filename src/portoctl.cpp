@@ -901,6 +901,47 @@ public:
     }
 };
 
+static void PrintPhases(const std::vector<std::pair<std::string, uint64_t>> &phases) {
+    for (auto &phase: phases)
+        std::cout << phase.first << " " << phase.second << " ms" << std::endl;
+}
+
+class TCheckpointCmd final : public ICmd {
+public:
+    TCheckpointCmd(Porto::Connection *api) : ICmd(api, "checkpoint", 2, "<container> <path>",
+        "dump container into new directory and stop it") {}
+
+    int Execute(TCommandEnviroment *env) final override {
+        const auto &args = env->GetArgs();
+        std::vector<std::pair<std::string, uint64_t>> phases;
+
+        int ret = Api->Checkpoint(args[0], TPath(args[1]).AbsolutePath().ToString(), &phases);
+        PrintPhases(phases);
+        if (ret)
+            PrintError("Can't checkpoint container");
+
+        return ret;
+    }
+};
+
+class TRestoreCmd final : public ICmd {
+public:
+    TRestoreCmd(Porto::Connection *api) : ICmd(api, "restore", 2, "<container> <path>",
+        "create container from checkpoint and resume its tasks") {}
+
+    int Execute(TCommandEnviroment *env) final override {
+        const auto &args = env->GetArgs();
+        std::vector<std::pair<std::string, uint64_t>> phases;
+
+        int ret = Api->Restore(args[0], TPath(args[1]).AbsolutePath().ToString(), &phases);
+        PrintPhases(phases);
+        if (ret)
+            PrintError("Can't restore container");
+
+        return ret;
+    }
+};
+
 class TGetCmd final : public ICmd {
 public:
     TGetCmd(Porto::Connection *api) : ICmd(api, "get", 1, "<container> <variable> [variable...]", "get container property or data") {}
@@ -2318,6 +2359,8 @@ int main(int argc, char *argv[]) {
     handler.RegisterCommand<TKillCmd>();
     handler.RegisterCommand<TPauseCmd>();
     handler.RegisterCommand<TResumeCmd>();
+    handler.RegisterCommand<TCheckpointCmd>();
+    handler.RegisterCommand<TRestoreCmd>();
     handler.RegisterCommand<TGetPropertyCmd>();
     handler.RegisterCommand<TSetPropertyCmd>();
     handler.RegisterCommand<TGetDataCmd>();
@@ -50,6 +50,7 @@ std::string PreviousVersion;
 static pid_t slavePid;
 static bool stdlog = false;
 static bool failsafe = false;
+static bool respawn = true;
 
 static void AllocStatistics() {
     Statistics = (TStatistics *)mmap(nullptr, sizeof(*Statistics),
@@ -120,6 +121,7 @@ struct TRequest {
     TContext *Context;
     std::shared_ptr<TClient> Client;
     rpc::TContainerRequest Request;
+    std::shared_ptr<TContainer> QueueOwner;
 };
 
 class TRpcWorker : public TWorker<TRequest> {
@@ -131,14 +133,26 @@ public:
     }
 
     bool Handle(const TRequest &request) override {
+        if (request.QueueOwner) {
+            HandleQueuedRequests(request.QueueOwner);
+            return true;
+        }
+
         HandleRpcRequest(*request.Context, request.Request, request.Client);
+        request.Client->ReleaseRequest();
 
         return true;
     }
 };
 
+static TPath PortoSocketPath() {
+    if (config.Simulate())
+        return TPath(config().daemon().simulate_dir()) / "portod.socket";
+    return TPath(PORTO_SOCKET_PATH);
+}
+
 static TError CreatePortoSocket() {
-    TPath path(PORTO_SOCKET_PATH);
+    TPath path = PortoSocketPath();
     struct sockaddr_un addr;
     TScopedFd fd;
     TError error;
@@ -177,9 +191,11 @@ static TError CreatePortoSocket() {
     if (bind(fd.GetFd(), (struct sockaddr *) &addr, sizeof(addr)) < 0)
         return TError(EError::Unknown, errno, "bind()");
 
-    error = path.Chown(0, GetPortoGroupId());
-    if (error)
-        return error;
+    if (!config.Simulate()) {
+        error = path.Chown(0, GetPortoGroupId());
+        if (error)
+            return error;
+    }
 
     error = path.Chmod(PORTO_SOCKET_MODE);
     if (error)
@@ -261,6 +277,12 @@ retry:
 }
 
 static void StartWorkers(TContext &context, TRpcWorker &worker) {
+    RequeueRpcRequests = [&context, &worker] (std::shared_ptr<TContainer> container) {
+        TRequest req {&context};
+        req.QueueOwner = container;
+        worker.Push(req);
+    };
+
     worker.Start();
     context.Queue->Start();
 }
@@ -268,6 +290,7 @@ static void StartWorkers(TContext &context, TRpcWorker &worker) {
 static void StopWorkers(TContext &context, TRpcWorker &worker) {
     context.Queue->Stop();
     worker.Stop();
+    RequeueRpcRequests = nullptr;
 }
 
 static int SlaveRpc(TContext &context, TRpcWorker &worker) {
@@ -407,7 +430,7 @@ static int SlaveRpc(TContext &context, TRpcWorker &worker) {
 
                     if (!error) {
                         error = client->IdentifyClient(*context.Cholder, false);
-                        if (!error)
+                        if (!error && !ThrottleRpcRequest(client))
                             worker.Push(req);
                     }
                 }
@@ -502,7 +525,9 @@ static int SlaveMain() {
     TRpcWorker worker(config().daemon().workers());
 
     ret = TuneLimits();
-    if (ret) {
+    if (ret && config.Simulate()) {
+        L_WRN() << "Can't set correct limits: " << strerror(errno) << std::endl;
+    } else if (ret) {
         L_ERR() << "Can't set correct limits: " << strerror(errno) << std::endl;
         return ret;
     }
@@ -550,7 +575,8 @@ static int SlaveMain() {
             return EXIT_FAILURE;
     }
 
-    TNetwork::InitializeUnmanagedDevices();
+    if (!config.Simulate())
+        TNetwork::InitializeUnmanagedDevices();
     InitContainerProperties();
 
     TContext context;
@@ -798,9 +824,21 @@ static int SpawnSlave(std::shared_ptr<TEpollLoop> loop, map<int,int> &exited) {
 
                 L_SYS() << "Updating" << std::endl;
 
-                const char *stdlogArg = nullptr;
+                /* Keep mode of daemon across update */
+                std::vector<const char *> args = { program_invocation_name };
                 if (stdlog)
-                    stdlogArg = "--stdlog";
+                    args.push_back("--stdlog");
+                if (Verbose)
+                    args.push_back("--verbose");
+                if (!respawn)
+                    args.push_back("--norespawn");
+                if (failsafe)
+                    args.push_back("--failsafe");
+                if (config.Simulate()) {
+                    args.push_back("--simulate");
+                    args.push_back(config.SimulateDir.c_str());
+                }
+                args.push_back(nullptr);
 
                 if (kill(slavePid, SIGHUP) < 0) {
                     L_ERR() << "Can't send SIGHUP to slave: " << strerror(errno) << std::endl;
@@ -812,8 +850,8 @@ static int SpawnSlave(std::shared_ptr<TEpollLoop> loop, map<int,int> &exited) {
                 close(evtfd[1]);
                 close(ackfd[0]);
                 loop->Destroy();
-                execlp(program_invocation_name, program_invocation_name, stdlogArg, nullptr);
-                std::cerr << "Can't execlp(" << program_invocation_name << ", " << program_invocation_name << ", NULL)" << strerror(errno) << std::endl;
+                execvp(program_invocation_name, (char **)args.data());
+                std::cerr << "Can't execvp(" << program_invocation_name << ")" << strerror(errno) << std::endl;
                 ret = EXIT_FAILURE;
                 goto exit;
             }
@@ -865,7 +903,7 @@ exit:
     return ret;
 }
 
-static int MasterMain(bool respawn) {
+static int MasterMain() {
     Statistics->MasterStarted = GetCurrentTimeMs();
 
     int ret = DaemonPrepare(true);
@@ -873,6 +911,8 @@ static int MasterMain(bool respawn) {
         return ret;
 
     TPath pathVer(PORTO_VERSION_FILE);
+    if (config.Simulate())
+        pathVer = TPath(config().daemon().simulate_dir()) / "portod.version";
 
     if (pathVer.ReadAll(PreviousVersion)) {
         (void)pathVer.Mkfile(0644);
@@ -892,7 +932,8 @@ static int MasterMain(bool respawn) {
         return EXIT_FAILURE;
 
     // We want propogate mounts into containers
-    error = TPath("/").Remount(MS_SHARED | MS_REC);
+    if (!config.Simulate())
+        error = TPath("/").Remount(MS_SHARED | MS_REC);
     if (error) {
         L_ERR() << "Can't remount / recursively as shared" << error << std::endl;
         return EXIT_FAILURE;
@@ -941,7 +982,7 @@ static int MasterMain(bool respawn) {
         PreviousVersion = PORTO_VERSION;
     }
 
-    error = TPath(PORTO_SOCKET_PATH).Unlink();
+    error = PortoSocketPath().Unlink();
     if (error)
         L_ERR() << "Cannot unlink socket file: " << error << std::endl;
 
@@ -989,19 +1030,8 @@ bool RunningInContainer() {
 
 int main(int argc, char * const argv[]) {
     bool slaveMode = false;
-    bool respawn = true;
     int argn;
 
-    if (getuid() != 0) {
-        std::cerr << "Need root privileges to start" << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    if (RunningInContainer()) {
-        std::cerr << "Can't start in container" << std::endl;
-        return EXIT_FAILURE;
-    }
-
     CatchFatalSignals();
 
     AllocStatistics();
@@ -1027,6 +1057,11 @@ int main(int argc, char * const argv[]) {
             respawn = false;
         } else if (arg == "--failsafe") {
             failsafe = true;
+        } else if (arg == "--simulate") {
+            if (argn + 1 >= argc)
+                return EXIT_FAILURE;
+            config.SimulateDir = argv[++argn];
+            config.Load();
         } else if (arg == "-t") {
             if (argn + 1 >= argc)
                 return EXIT_FAILURE;
@@ -1037,7 +1072,19 @@ int main(int argc, char * const argv[]) {
         }
     }
 
-    if (!slaveMode && AnotherInstanceRunning(PORTO_SOCKET_PATH)) {
+    if (!config.Simulate()) {
+        if (getuid() != 0) {
+            std::cerr << "Need root privileges to start" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (RunningInContainer()) {
+            std::cerr << "Can't start in container" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!slaveMode && AnotherInstanceRunning(PortoSocketPath().ToString())) {
         std::cerr << "Another instance of portod is running!" << std::endl;
         return EXIT_FAILURE;
     }
@@ -1055,7 +1102,7 @@ int main(int argc, char * const argv[]) {
         if (slaveMode)
             return SlaveMain();
         else
-            return MasterMain(respawn);
+            return MasterMain();
     } catch (std::string s) {
         L_ERR() << "EXCEPTION: " << s << std::endl;
         Crash();
@@ -480,7 +480,7 @@ TError TCpuPolicy::Set(const std::string &policy) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto cpucg = CurrentContainer->GetCgroup(CpuSubsystem);
+        auto cpucg = CurrentContainer->GetKnobCgroup(CpuSubsystem);
         error = CpuSubsystem.SetCpuPolicy(cpucg, policy,
                                           CurrentContainer->CpuGuarantee,
                                           CurrentContainer->CpuLimit);
@@ -524,7 +524,7 @@ TError TCpuPolicy::Propagate(const std::string &policy) {
                     CurrentContainer->GetState() == EContainerState::Meta ||
                     CurrentContainer->GetState() == EContainerState::Paused) {
 
-                    auto cpucg = CurrentContainer->GetCgroup(CpuSubsystem);
+                    auto cpucg = CurrentContainer->GetKnobCgroup(CpuSubsystem);
                     error = CpuSubsystem.SetCpuPolicy(cpucg, policy,
                                                       CurrentContainer->CpuGuarantee,
                                                       CurrentContainer->CpuLimit);
@@ -574,8 +574,9 @@ TError TIoPolicy::Set(const std::string &policy) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto blkcg = CurrentContainer->GetCgroup(BlkioSubsystem);
-        error = BlkioSubsystem.SetPolicy(blkcg, policy == "batch");
+        auto blkcg = CurrentContainer->GetKnobCgroup(BlkioSubsystem);
+        error = BlkioSubsystem.SetPolicy(blkcg, policy == "batch",
+                                         CurrentContainer->IoWeight);
 
         if (error) {
             L_ERR() << "Can't set " << P_IO_POLICY << ": " << error << std::endl;
@@ -616,8 +617,9 @@ TError TIoPolicy::Propagate(const std::string &policy) {
                     CurrentContainer->GetState() == EContainerState::Meta ||
                     CurrentContainer->GetState() == EContainerState::Paused) {
 
-                    auto blkcg = CurrentContainer->GetCgroup(BlkioSubsystem);
-                    error = BlkioSubsystem.SetPolicy(blkcg, policy == "batch");
+                    auto blkcg = CurrentContainer->GetKnobCgroup(BlkioSubsystem);
+                    error = BlkioSubsystem.SetPolicy(blkcg, policy == "batch",
+                                                     CurrentContainer->IoWeight);
                 }
 
                 if (error) {
@@ -737,12 +739,14 @@ TError TMemoryGuarantee::Set(const std::string &mem_guarantee) {
         return error;
 
     CurrentContainer->CurrentMemGuarantee = new_val;
+    CurrentContainer->UpdateHierarchy();
 
     uint64_t usage = CurrentContainer->GetRoot()->GetHierarchyMemGuarantee();
     uint64_t total = GetTotalMemory();
     uint64_t reserve = config().daemon().memory_guarantee_reserve();
     if (usage + reserve > total) {
         CurrentContainer->CurrentMemGuarantee = CurrentContainer->MemGuarantee;
+        CurrentContainer->UpdateHierarchy();
 
         return TError(EError::ResourceNotAvailable,
                 "can't guarantee all available memory: requested " +
@@ -753,11 +757,12 @@ TError TMemoryGuarantee::Set(const std::string &mem_guarantee) {
     if (CurrentContainer->GetState() == EContainerState::Running ||
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
-        auto memcg = CurrentContainer->GetCgroup(MemorySubsystem);
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
         error = MemorySubsystem.SetGuarantee(memcg, new_val);
 
         if (error) {
             CurrentContainer->CurrentMemGuarantee = CurrentContainer->MemGuarantee;
+            CurrentContainer->UpdateHierarchy();
             L_ERR() << "Can't set " << P_MEM_GUARANTEE << ": " << error << std::endl;
 
             return error;
@@ -1628,11 +1633,16 @@ TError TMemoryLimit::Set(const std::string &limit) {
     if (error)
         return error;
 
+    if (new_size && CurrentContainer->MemHighLimit &&
+            CurrentContainer->MemHighLimit > new_size)
+        return TError(EError::InvalidValue, std::string(P_MEM_LIMIT) +
+                      " must not be below " + P_MEM_HIGH_LIMIT);
+
     if (CurrentContainer->GetState() == EContainerState::Running ||
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto memcg = CurrentContainer->GetCgroup(MemorySubsystem);
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
         error = MemorySubsystem.SetLimit(memcg, new_size);
 
         if (error) {
@@ -1647,6 +1657,7 @@ TError TMemoryLimit::Set(const std::string &limit) {
     }
 
     CurrentContainer->MemLimit = new_size;
+    CurrentContainer->UpdateHierarchy();
     CurrentContainer->PropMask |= MEM_LIMIT_SET;
 
     return TError::Success();
@@ -1658,6 +1669,58 @@ TError TMemoryLimit::Get(std::string &value) {
     return TError::Success();
 }
 
+class TMemoryHighLimit : public TProperty {
+public:
+    TError Set(const std::string &limit);
+    TError Get(std::string &value);
+    TMemoryHighLimit() : TProperty(P_MEM_HIGH_LIMIT, MEM_HIGH_LIMIT_SET,
+                                   "Memory usage above which container is throttled "
+                                   "and reclaimed [bytes] (dynamic)") {}
+    void Init(void) {
+        IsSupported = MemorySubsystem.SupportHighLimit();
+    }
+} static MemoryHighLimit;
+
+TError TMemoryHighLimit::Set(const std::string &limit) {
+    TError error = IsAlive();
+    if (error)
+        return error;
+
+    uint64_t new_size = 0lu;
+    error = StringToSize(limit, new_size);
+    if (error)
+        return error;
+
+    if (new_size && CurrentContainer->MemLimit && new_size > CurrentContainer->MemLimit)
+        return TError(EError::InvalidValue, std::string(P_MEM_HIGH_LIMIT) +
+                      " must not be above " + P_MEM_LIMIT);
+
+    if (CurrentContainer->GetState() == EContainerState::Running ||
+        CurrentContainer->GetState() == EContainerState::Meta ||
+        CurrentContainer->GetState() == EContainerState::Paused) {
+
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
+        error = MemorySubsystem.SetHighLimit(memcg, new_size);
+
+        if (error) {
+            L_ERR() << "Can't set " << P_MEM_HIGH_LIMIT << ": " << error << std::endl;
+
+            return error;
+        }
+    }
+
+    CurrentContainer->MemHighLimit = new_size;
+    CurrentContainer->PropMask |= MEM_HIGH_LIMIT_SET;
+
+    return TError::Success();
+}
+
+TError TMemoryHighLimit::Get(std::string &value) {
+    value = std::to_string(CurrentContainer->MemHighLimit);
+
+    return TError::Success();
+}
+
 class TAnonLimit : public TProperty {
 public:
     TError Set(const std::string &limit);
@@ -1684,7 +1747,7 @@ TError TAnonLimit::Set(const std::string &limit) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto memcg = CurrentContainer->GetCgroup(MemorySubsystem);
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
         error = MemorySubsystem.SetAnonLimit(memcg, new_size);
 
         if (error) {
@@ -1732,7 +1795,7 @@ TError TDirtyLimit::Set(const std::string &limit) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto memcg = CurrentContainer->GetCgroup(MemorySubsystem);
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
         error = MemorySubsystem.SetDirtyLimit(memcg, new_size);
 
         if (error) {
@@ -1754,6 +1817,52 @@ TError TDirtyLimit::Get(std::string &value) {
     return TError::Success();
 }
 
+class TThreadLimit : public TProperty {
+public:
+    TError Set(const std::string &limit);
+    TError Get(std::string &value);
+    TThreadLimit() : TProperty(P_THREAD_LIMIT, THREAD_LIMIT_SET,
+                               "Limit of threads and processes in subtree, "
+                               "0 - unlimited (dynamic)") {}
+    void Init(void) {
+        IsSupported = PidsSubsystem.Supported();
+    }
+} static ThreadLimit;
+
+TError TThreadLimit::Set(const std::string &limit) {
+    TError error = IsAlive();
+    if (error)
+        return error;
+
+    uint64_t new_limit;
+    error = StringToUint64(limit, new_limit);
+    if (error)
+        return error;
+
+    if (CurrentContainer->GetState() == EContainerState::Running ||
+        CurrentContainer->GetState() == EContainerState::Meta ||
+        CurrentContainer->GetState() == EContainerState::Paused) {
+
+        auto cg = CurrentContainer->GetKnobCgroup(PidsSubsystem);
+        error = PidsSubsystem.SetLimit(cg, new_limit);
+        if (error) {
+            L_ERR() << "Can't set " << P_THREAD_LIMIT << ": " << error << std::endl;
+            return error;
+        }
+    }
+
+    CurrentContainer->ThreadLimit = new_limit;
+    CurrentContainer->PropMask |= THREAD_LIMIT_SET;
+
+    return TError::Success();
+}
+
+TError TThreadLimit::Get(std::string &value) {
+    value = std::to_string(CurrentContainer->ThreadLimit);
+
+    return TError::Success();
+}
+
 class TRechargeOnPgfault : public TProperty {
 public:
     TError Set(const std::string &recharge);
@@ -1784,7 +1893,7 @@ TError TRechargeOnPgfault::Set(const std::string &recharge) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto memcg = CurrentContainer->GetCgroup(MemorySubsystem);
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
         error = MemorySubsystem.RechargeOnPgfault(memcg, new_val);
 
         if (error) {
@@ -1828,7 +1937,7 @@ TError TCpuLimit::Set(const std::string &limit) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto cpucg = CurrentContainer->GetCgroup(CpuSubsystem);
+        auto cpucg = CurrentContainer->GetKnobCgroup(CpuSubsystem);
         error = CpuSubsystem.SetCpuPolicy(cpucg, CurrentContainer->CpuPolicy,
                                           CurrentContainer->CpuGuarantee,
                                           new_limit);
@@ -1875,7 +1984,7 @@ TError TCpuGuarantee::Set(const std::string &guarantee) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto cpucg = CurrentContainer->GetCgroup(CpuSubsystem);
+        auto cpucg = CurrentContainer->GetKnobCgroup(CpuSubsystem);
         error = CpuSubsystem.SetCpuPolicy(cpucg, CurrentContainer->CpuPolicy,
                                           new_guarantee,
                                           CurrentContainer->CpuLimit);
@@ -1925,7 +2034,7 @@ TError TIoLimit::Set(const std::string &limit) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto memcg = CurrentContainer->GetCgroup(MemorySubsystem);
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
         error = MemorySubsystem.SetIoLimit(memcg, new_limit);
         if (error) {
             L_ERR() << "Can't set " << P_IO_LIMIT << ": " << error << std::endl;
@@ -1971,7 +2080,7 @@ TError TIopsLimit::Set(const std::string &limit) {
         CurrentContainer->GetState() == EContainerState::Meta ||
         CurrentContainer->GetState() == EContainerState::Paused) {
 
-        auto memcg = CurrentContainer->GetCgroup(MemorySubsystem);
+        auto memcg = CurrentContainer->GetKnobCgroup(MemorySubsystem);
         error = MemorySubsystem.SetIopsLimit(memcg, new_limit);
         if (error) {
             L_ERR() << "Can't set " << P_IO_OPS_LIMIT << ": " << error << std::endl;
@@ -2146,6 +2255,195 @@ TError TNetLimit::GetIndexed(const std::string &index,
     return TError::Success();
 }
 
+class TIoWeight : public TProperty {
+public:
+    TError Set(const std::string &weight);
+    TError Get(std::string &value);
+    TError SetIndexed(const std::string &index, const std::string &weight);
+    TError GetIndexed(const std::string &index, std::string &value);
+    TIoWeight() : TProperty(P_IO_WEIGHT, IO_WEIGHT_SET,
+                            "Proportional share of disk time among siblings: "
+                            "<disk>|default <10..1000>;... (dynamic)") {}
+    void Init(void) {
+        IsSupported = BlkioSubsystem.SupportPolicy();
+    }
+
+    TError Apply(TUintMap &new_weight);
+} static IoWeight;
+
+TError TIoWeight::Apply(TUintMap &new_weight) {
+    TError error = IsAlive();
+    if (error)
+        return error;
+
+    if (new_weight.find("default") == new_weight.end())
+        new_weight["default"] = 0;
+
+    /* reset per-disk weights dropped from the map */
+    TUintMap apply = new_weight;
+    for (auto &w: CurrentContainer->IoWeight)
+        if (apply.find(w.first) == apply.end())
+            apply[w.first] = 0;
+
+    for (auto &w: apply) {
+        std::string majmin;
+
+        if (w.second && (w.second < 10 || w.second > 1000))
+            return TError(EError::InvalidValue, "io weight out of range 10..1000: " +
+                          std::to_string(w.second));
+
+        if (w.first == "default")
+            continue;
+
+        if (!BlkioSubsystem.SupportDeviceWeight())
+            return TError(EError::NotSupported, "per-disk io weight is not supported");
+
+        error = BlkioSubsystem.GetDiskDevice(w.first, majmin);
+        if (error)
+            return error;
+    }
+
+    if (CurrentContainer->GetState() == EContainerState::Running ||
+        CurrentContainer->GetState() == EContainerState::Meta ||
+        CurrentContainer->GetState() == EContainerState::Paused) {
+
+        auto blkcg = CurrentContainer->GetKnobCgroup(BlkioSubsystem);
+        error = BlkioSubsystem.SetPolicy(blkcg, CurrentContainer->IoPolicy == "batch",
+                                         apply);
+        if (error) {
+            L_ERR() << "Can't set " << P_IO_WEIGHT << ": " << error << std::endl;
+            return error;
+        }
+    }
+
+    for (auto it = new_weight.begin(); it != new_weight.end(); ) {
+        if (!it->second && it->first != "default")
+            it = new_weight.erase(it);
+        else
+            ++it;
+    }
+
+    CurrentContainer->IoWeight = new_weight;
+    CurrentContainer->PropMask |= IO_WEIGHT_SET;
+
+    return TError::Success();
+}
+
+TError TIoWeight::Set(const std::string &weight) {
+    TUintMap new_weight;
+    TError error = StringToUintMap(weight, new_weight);
+    if (error)
+        return error;
+
+    return Apply(new_weight);
+}
+
+TError TIoWeight::Get(std::string &value) {
+    return UintMapToString(CurrentContainer->IoWeight, value);
+}
+
+TError TIoWeight::SetIndexed(const std::string &index,
+                             const std::string &weight) {
+    uint64_t val;
+    TError error = StringToUint64(weight, val);
+    if (error)
+        return TError(EError::InvalidValue, "Invalid value " + weight);
+
+    TUintMap new_weight = CurrentContainer->IoWeight;
+    new_weight[index] = val;
+
+    return Apply(new_weight);
+}
+
+TError TIoWeight::GetIndexed(const std::string &index,
+                             std::string &value) {
+    auto it = CurrentContainer->IoWeight.find(index);
+    if (it == CurrentContainer->IoWeight.end())
+        return TError(EError::InvalidValue, "invalid index " + index);
+
+    value = std::to_string(it->second);
+
+    return TError::Success();
+}
+
+class TNetRxLimit : public TProperty {
+public:
+    TError Set(const std::string &limit);
+    TError Get(std::string &value);
+    TError SetIndexed(const std::string &index, const std::string &limit);
+    TError GetIndexed(const std::string &index, std::string &value);
+    TNetRxLimit() : TProperty(P_NET_RX_LIMIT, NET_RX_LIMIT_SET,
+                              "Maximum container ingress network bandwidth: "
+                              "<interface>|default <Bps>;... (dynamic)") {}
+} static NetRxLimit;
+
+TError TNetRxLimit::Set(const std::string &limit) {
+    TError error = IsAlive();
+    if (error)
+        return error;
+
+    TUintMap new_limit;
+    error = StringToUintMap(limit, new_limit);
+    if (error)
+        return error;
+
+    TUintMap old_limit = CurrentContainer->NetRxLimit;
+    CurrentContainer->NetRxLimit = new_limit;
+    if (CurrentContainer->NetRxLimit.find("default") ==
+            CurrentContainer->NetRxLimit.end())
+        CurrentContainer->NetRxLimit["default"] = 0;
+
+    error = CurrentContainer->UpdateIngressLimits();
+    if (!error) {
+        CurrentContainer->PropMask |= NET_RX_LIMIT_SET;
+    } else {
+        L_ERR() << "Cannot update ingress limit : " << error << std::endl;
+        CurrentContainer->NetRxLimit = old_limit;
+    }
+
+    return error;
+}
+
+TError TNetRxLimit::Get(std::string &value) {
+    return UintMapToString(CurrentContainer->NetRxLimit, value);
+}
+
+TError TNetRxLimit::SetIndexed(const std::string &index,
+                               const std::string &limit) {
+    TError error = IsAlive();
+    if (error)
+        return error;
+
+    uint64_t val;
+    error = StringToSize(limit, val);
+    if (error)
+        return TError(EError::InvalidValue, "Invalid value " + limit);
+
+    TUintMap old_limit = CurrentContainer->NetRxLimit;
+    CurrentContainer->NetRxLimit[index] = val;
+
+    error = CurrentContainer->UpdateIngressLimits();
+    if (!error) {
+        CurrentContainer->PropMask |= NET_RX_LIMIT_SET;
+    } else {
+        L_ERR() << "Cannot update ingress limit : " << error << std::endl;
+        CurrentContainer->NetRxLimit = old_limit;
+    }
+
+    return error;
+}
+
+TError TNetRxLimit::GetIndexed(const std::string &index,
+                               std::string &value) {
+    auto it = CurrentContainer->NetRxLimit.find(index);
+    if (it == CurrentContainer->NetRxLimit.end())
+        return TError(EError::InvalidValue, "invalid index " + index);
+
+    value = std::to_string(it->second);
+
+    return TError::Success();
+}
+
 class TNetPriority : public TProperty {
 public:
     TError Set(const std::string &prio);
@@ -2559,6 +2857,93 @@ TError TOomKilled::Get(std::string &value) {
     return GetToSave(value);
 }
 
+class TOomCount : public TProperty {
+public:
+    TError SetFromRestore(const std::string &value);
+    TError Get(std::string &value);
+    TOomCount() : TProperty(D_OOM_COUNT, OOM_COUNT_SET,
+                            "how many times container has been killed by OOM (ro)") {
+        IsReadOnly = true;
+    }
+} static OomCount;
+
+TError TOomCount::SetFromRestore(const std::string &value) {
+    return StringToUint64(value, CurrentContainer->OomCount);
+}
+
+TError TOomCount::Get(std::string &value) {
+    value = std::to_string(CurrentContainer->OomCount);
+
+    return TError::Success();
+}
+
+class TOomEvents : public TProperty {
+public:
+    TError SetFromRestore(const std::string &value);
+    TError Get(std::string &value);
+    TOomEvents() : TProperty(D_OOM_EVENTS, OOM_EVENTS_SET,
+                             "recent OOM kills: <unix time> <pid> <comm> "
+                             "<usage> <limit>;... (ro)") {
+        IsReadOnly = true;
+    }
+} static OomEvents;
+
+TError TOomEvents::SetFromRestore(const std::string &value) {
+    std::vector<std::string> events;
+    TError error;
+
+    CurrentContainer->OomEvents.clear();
+
+    error = SplitString(value, ';', events);
+    if (error)
+        return error;
+
+    for (auto &event: events) {
+        std::vector<std::string> fields;
+        TOomEvent oom;
+        int pid;
+
+        if (StringTrim(event).empty())
+            continue;
+
+        error = SplitString(StringTrim(event), ' ', fields);
+        if (error)
+            return error;
+        if (fields.size() != 5)
+            return TError(EError::InvalidValue, "Invalid oom event: " + event);
+
+        error = StringToUint64(fields[0], oom.Time);
+        if (!error)
+            error = StringToInt(fields[1], pid);
+        if (!error)
+            error = StringToUint64(fields[3], oom.Usage);
+        if (!error)
+            error = StringToUint64(fields[4], oom.Limit);
+        if (error)
+            return error;
+
+        oom.Pid = pid;
+        oom.Comm = fields[2];
+        CurrentContainer->OomEvents.push_back(oom);
+    }
+
+    return TError::Success();
+}
+
+TError TOomEvents::Get(std::string &value) {
+    value = "";
+
+    for (auto &oom: CurrentContainer->OomEvents) {
+        if (!value.empty())
+            value += "; ";
+        value += std::to_string(oom.Time) + " " + std::to_string(oom.Pid) + " " +
+                 oom.Comm + " " + std::to_string(oom.Usage) + " " +
+                 std::to_string(oom.Limit);
+    }
+
+    return TError::Success();
+}
+
 class TParent : public TProperty {
 public:
     TError Get(std::string &value);
@@ -2597,6 +2982,38 @@ TError TRespawnCount::Get(std::string &value) {
     return TError::Success();
 }
 
+class TRespawnDelay : public TProperty {
+public:
+    TError Get(std::string &value);
+    TRespawnDelay() : TProperty(D_RESPAWN_DELAY, 0,
+                                "last respawn backoff delay in ms (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+} static RespawnDelay;
+
+TError TRespawnDelay::Get(std::string &value) {
+    value = std::to_string(CurrentContainer->RespawnDelay);
+
+    return TError::Success();
+}
+
+class TRespawnAttempts : public TProperty {
+public:
+    TError Get(std::string &value);
+    TRespawnAttempts() : TProperty(D_RESPAWN_ATTEMPTS, 0,
+                                   "respawns in a row without stable run (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+} static RespawnAttempts;
+
+TError TRespawnAttempts::Get(std::string &value) {
+    value = std::to_string(CurrentContainer->RespawnAttempts);
+
+    return TError::Success();
+}
+
 class TRootPid : public TProperty {
 public:
     TError Get(std::string &value);
@@ -2711,9 +3128,12 @@ TError TStdoutOffset::Get(std::string &value) {
     if (error)
         return error;
 
-    value = std::to_string(CurrentContainer->StdoutOffset);
+    uint64_t offset;
+    error = CurrentContainer->GetStdout().GetOffset(CurrentContainer->StdoutOffset, offset);
+    if (!error)
+        value = std::to_string(offset);
 
-    return TError::Success();
+    return error;
 }
 
 class TStderr : public TProperty {
@@ -2763,9 +3183,12 @@ TError TStderrOffset::Get(std::string &value) {
     if (error)
         return error;
 
-    value = std::to_string(CurrentContainer->StderrOffset);
+    uint64_t offset;
+    error = CurrentContainer->GetStderr().GetOffset(CurrentContainer->StderrOffset, offset);
+    if (!error)
+        value = std::to_string(offset);
 
-    return TError::Success();
+    return error;
 }
 
 class TMemUsage : public TProperty {
@@ -2823,26 +3246,82 @@ TError TAnonUsage::Get(std::string &value) {
     return TError::Success();
 }
 
-class TMinorFaults : public TProperty {
+class TThreadCount : public TProperty {
 public:
     TError Get(std::string &value);
-    TMinorFaults() : TProperty(D_MINOR_FAULTS, 0, "minor page faults (ro)") {
+    TThreadCount() : TProperty(D_THREAD_COUNT, 0,
+                               "current count of threads in subtree (ro)") {
         IsReadOnly = true;
         IsSerializable = false;
     }
-} static MinorFaults;
+    void Init(void) {
+        IsSupported = PidsSubsystem.Supported();
+    }
+} static ThreadCount;
 
-TError TMinorFaults::Get(std::string &value) {
+TError TThreadCount::Get(std::string &value) {
     TError error = IsRunning();
     if (error)
         return error;
 
-    auto cg = CurrentContainer->GetCgroup(MemorySubsystem);
-    TUintMap stat;
+    auto cg = CurrentContainer->GetCgroup(PidsSubsystem);
+    uint64_t val;
 
-    if (MemorySubsystem.Statistics(cg, stat))
-        value = "-1";
-    else
+    error = PidsSubsystem.Usage(cg, val);
+    if (!error)
+        value = std::to_string(val);
+
+    return error;
+}
+
+class TForksRejected : public TProperty {
+public:
+    TError Get(std::string &value);
+    TForksRejected() : TProperty(D_FORKS_REJECTED, 0,
+                                 "forks failed because of thread_limit (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = PidsSubsystem.Supported();
+    }
+} static ForksRejected;
+
+TError TForksRejected::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(PidsSubsystem);
+    uint64_t val;
+
+    error = PidsSubsystem.GetRejected(cg, val);
+    if (!error)
+        value = std::to_string(val);
+
+    return error;
+}
+
+class TMinorFaults : public TProperty {
+public:
+    TError Get(std::string &value);
+    TMinorFaults() : TProperty(D_MINOR_FAULTS, 0, "minor page faults (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+} static MinorFaults;
+
+TError TMinorFaults::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(MemorySubsystem);
+    TUintMap stat;
+
+    if (MemorySubsystem.Statistics(cg, stat))
+        value = "-1";
+    else
         value = std::to_string(stat["total_pgfault"] - stat["total_pgmajfault"]);
 
     return TError::Success();
@@ -2905,6 +3384,59 @@ TError TMaxRss::Get(std::string &value) {
     return TError::Success();
 }
 
+class TMemoryStat : public TProperty {
+    const bool Hierarchical;
+public:
+    TError Get(std::string &value);
+    TError GetIndexed(const std::string &index, std::string &value);
+    TMemoryStat(const char *name, bool hierarchical, const char *desc) :
+            TProperty(name, 0, desc), Hierarchical(hierarchical) {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+};
+
+static TMemoryStat MemoryStat(D_MEMORY_STAT, false,
+        "memory statistics [bytes]: cache|rss|mapped|dirty|writeback|swap: <bytes>; "
+        "pgscan|pgsteal|failcnt: <count>;... (ro)");
+static TMemoryStat MemoryStatTotal(D_MEMORY_STAT_TOTAL, true,
+        "memory statistics including childs, syntax as memory_stat (ro)");
+
+TError TMemoryStat::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(MemorySubsystem);
+    TUintMap stat;
+
+    error = MemorySubsystem.GetMemoryStat(cg, Hierarchical, stat);
+    if (error)
+        return error;
+
+    return UintMapToString(stat, value);
+}
+
+TError TMemoryStat::GetIndexed(const std::string &index, std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(MemorySubsystem);
+    TUintMap stat;
+
+    error = MemorySubsystem.GetMemoryStat(cg, Hierarchical, stat);
+    if (error)
+        return error;
+
+    if (stat.find(index) == stat.end())
+        return TError(EError::InvalidValue, "Invalid subscript for property");
+
+    value = std::to_string(stat[index]);
+
+    return TError::Success();
+}
+
 class TCpuUsage : public TProperty {
 public:
     TError Get(std::string &value);
@@ -2964,6 +3496,146 @@ TError TCpuSystem::Get(std::string &value) {
     return TError::Success();
 }
 
+class TCpuThrottled : public TProperty {
+public:
+    TError Get(std::string &value);
+    TCpuThrottled() : TProperty(D_CPU_THROTTLED, 0,
+                                "time throttled by cpu_limit [nanoseconds] (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = CpuSubsystem.HasQuota;
+    }
+} static CpuThrottled;
+
+TError TCpuThrottled::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(CpuSubsystem);
+    uint64_t periods, time;
+
+    error = CpuSubsystem.GetThrottling(cg, periods, time);
+    if (!error)
+        value = std::to_string(time);
+
+    return error;
+}
+
+class TCpuThrottledPeriods : public TProperty {
+public:
+    TError Get(std::string &value);
+    TCpuThrottledPeriods() : TProperty(D_CPU_THROTTLED_PERIODS, 0,
+                                       "count of periods throttled by cpu_limit (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = CpuSubsystem.HasQuota;
+    }
+} static CpuThrottledPeriods;
+
+TError TCpuThrottledPeriods::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(CpuSubsystem);
+    uint64_t periods, time;
+
+    error = CpuSubsystem.GetThrottling(cg, periods, time);
+    if (!error)
+        value = std::to_string(periods);
+
+    return error;
+}
+
+class TMemoryHighEvents : public TProperty {
+public:
+    TError Get(std::string &value);
+    TMemoryHighEvents() : TProperty(D_MEMORY_HIGH_EVENTS, 0,
+                                    "times memory usage went above memory_high (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = MemorySubsystem.SupportHighEvents();
+    }
+} static MemoryHighEvents;
+
+TError TMemoryHighEvents::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(MemorySubsystem);
+    uint64_t val;
+
+    error = MemorySubsystem.GetHighEvents(cg, val);
+    if (!error)
+        value = std::to_string(val);
+
+    return error;
+}
+
+class TMemoryStall : public TProperty {
+public:
+    TError Get(std::string &value);
+    TMemoryStall() : TProperty(D_MEMORY_STALL, 0,
+                               "time tasks stalled in memory reclaim and throttling [nanoseconds] (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = MemorySubsystem.SupportStallTime();
+    }
+} static MemoryStall;
+
+TError TMemoryStall::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(MemorySubsystem);
+    uint64_t val;
+
+    error = MemorySubsystem.GetStallTime(cg, val);
+    if (!error)
+        value = std::to_string(val);
+
+    return error;
+}
+
+class TCpuWait : public TProperty {
+public:
+    TError Get(std::string &value);
+    TCpuWait() : TProperty(D_CPU_WAIT, 0,
+                           "time runnable tasks waited for cpu [nanoseconds] (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = CpuacctSubsystem.SupportWaitTime();
+    }
+} static CpuWait;
+
+TError TCpuWait::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    auto cg = CurrentContainer->GetCgroup(CpuacctSubsystem);
+    uint64_t val;
+
+    error = CpuacctSubsystem.WaitTime(cg, val);
+    if (!error)
+        value = std::to_string(val);
+
+    return error;
+}
+
 class TNetBytes : public TProperty {
 public:
     TError Get(std::string &value);
@@ -3240,6 +3912,46 @@ TError TNetRxDrops::GetIndexed(const std::string &index,
     return TError::Success();
 }
 
+class TNetRxOverlimits : public TProperty {
+public:
+    TError Get(std::string &value);
+    TError GetIndexed(const std::string &index, std::string &value);
+    TNetRxOverlimits() : TProperty(D_NET_RX_OVERLIMITS, 0,
+                                   "rx packets delayed by net_rx_limit: "
+                                   "<interface>: <packets>;... (ro)") {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+} static NetRxOverlimits;
+
+TError TNetRxOverlimits::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    TUintMap m;
+    (void)CurrentContainer->GetStat(ETclassStat::RxOverlimits, m);
+
+    return UintMapToString(m, value);
+}
+
+TError TNetRxOverlimits::GetIndexed(const std::string &index,
+                                    std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    TUintMap m;
+    (void)CurrentContainer->GetStat(ETclassStat::RxOverlimits, m);
+
+    if (m.find(index) == m.end())
+        return TError(EError::InvalidValue, "Invalid subscript for property");
+
+    value = std::to_string(m[index]);
+
+    return TError::Success();
+}
+
 class TIoRead : public TProperty {
 public:
     void Populate(TUintMap &m);
@@ -3408,6 +4120,126 @@ TError TIoOps::GetIndexed(const std::string &index,
     return TError::Success();
 }
 
+class TIoBlkioStat : public TProperty {
+    const std::string Knob;
+public:
+    void Populate(TUintMap &m);
+    TError Get(std::string &value);
+    TError GetIndexed(const std::string &index, std::string &value);
+    TIoBlkioStat(const char *name, const char *knob, const char *desc) :
+            TProperty(name, 0, desc), Knob(knob) {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = BlkioSubsystem.SupportTimeStats();
+    }
+};
+
+static TIoBlkioStat IoTime(D_IO_TIME, "blkio.io_service_time_recursive",
+        "time disks spent serving requests [nanoseconds]: <disk>: <time>;... (ro)");
+static TIoBlkioStat IoWait(D_IO_WAIT, "blkio.io_wait_time_recursive",
+        "time requests waited in scheduler queues [nanoseconds]: <disk>: <time>;... (ro)");
+static TIoBlkioStat IoQueued(D_IO_QUEUED, "blkio.io_queued_recursive",
+        "requests queued right now: <disk>: <count>;... (ro)");
+
+void TIoBlkioStat::Populate(TUintMap &m) {
+    auto blkCg = CurrentContainer->GetCgroup(BlkioSubsystem);
+    std::vector<BlkioStat> blkStat;
+
+    TError error = BlkioSubsystem.Statistics(blkCg, Knob, blkStat);
+    if (!error) {
+        for (auto &s : blkStat)
+            m[s.Device] = s.Read + s.Write;
+    }
+}
+
+TError TIoBlkioStat::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    TUintMap m;
+    Populate(m);
+
+    return UintMapToString(m, value);
+}
+
+TError TIoBlkioStat::GetIndexed(const std::string &index,
+                                std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    TUintMap m;
+    Populate(m);
+
+    if (m.find(index) == m.end())
+        return TError(EError::InvalidValue, "Invalid subscript for property");
+
+    value = std::to_string(m[index]);
+
+    return TError::Success();
+}
+
+class TIoShare : public TProperty {
+    const bool Entitled;
+public:
+    void Populate(TUintMap &m);
+    TError Get(std::string &value);
+    TError GetIndexed(const std::string &index, std::string &value);
+    TIoShare(const char *name, bool entitled, const char *desc) :
+            TProperty(name, 0, desc), Entitled(entitled) {
+        IsReadOnly = true;
+        IsSerializable = false;
+    }
+    void Init(void) {
+        IsSupported = BlkioSubsystem.SupportPolicy();
+    }
+};
+
+static TIoShare IoShare(D_IO_SHARE, false,
+        "share of disk traffic among siblings [permille]: <disk>: <share>;... (ro)");
+static TIoShare IoWeightShare(D_IO_WEIGHT_SHARE, true,
+        "share of io weight among siblings [permille]: <disk>: <share>;... (ro)");
+
+void TIoShare::Populate(TUintMap &m) {
+    auto blkCg = CurrentContainer->GetCgroup(BlkioSubsystem);
+    TUintMap received, entitled;
+
+    TError error = BlkioSubsystem.GetShares(blkCg, received, entitled);
+    if (!error)
+        m = Entitled ? entitled : received;
+}
+
+TError TIoShare::Get(std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    TUintMap m;
+    Populate(m);
+
+    return UintMapToString(m, value);
+}
+
+TError TIoShare::GetIndexed(const std::string &index,
+                            std::string &value) {
+    TError error = IsRunning();
+    if (error)
+        return error;
+
+    TUintMap m;
+    Populate(m);
+
+    if (m.find(index) == m.end())
+        return TError(EError::InvalidValue, "Invalid subscript for property");
+
+    value = std::to_string(m[index]);
+
+    return TError::Success();
+}
+
 class TTime : public TProperty {
 public:
     TError Get(std::string &value);
@@ -3483,6 +4315,20 @@ void TPortoStat::Populate(TUintMap &m) {
     m["rotated"] = Statistics->Rotated;
     m["restore_failed"] = Statistics->RestoreFailed;
     m["started"] = Statistics->Started;
+    m["respawned"] = Statistics->Respawned;
+    m["respawn_throttled"] = Statistics->RespawnThrottled;
+    m["queued_requests"] = Statistics->QueuedRequests;
+    m["queue_timeouts"] = Statistics->QueueTimeouts;
+    m["reconcile_passes"] = Statistics->ReconcilePasses;
+    m["reconcile_lag_ms"] = GetCurrentTimeMs() - Statistics->ReconcileSynced;
+    m["cgroup_discrepancies"] = Statistics->CgroupDiscrepancies;
+    m["cgroup_repairs"] = Statistics->CgroupRepairs;
+    m["hierarchy_mismatches"] = Statistics->HierarchyMismatches;
+    m["cgroup_writes_skipped"] = Statistics->CgroupWritesSkipped;
+    m["requests_throttled"] = Statistics->RequestsThrottled;
+    m["containers_oom"] = Statistics->ContainersOom;
+    m["checkpoints"] = Statistics->Checkpoints;
+    m["restores"] = Statistics->Restores;
     m["running"] = CurrentContainer->GetRunningChildren();
     uint64_t usage = 0;
     auto cg = MemorySubsystem.Cgroup(PORTO_DAEMON_CGROUP);
@@ -10,6 +10,7 @@ constexpr const char *P_RAW_LOOP_DEV = "_loop_dev";
 constexpr const char *P_RAW_NAME = "_name";
 constexpr const char *P_RAW_START_TIME = "_start_time";
 constexpr const char *P_RAW_DEATH_TIME = "_death_time";
+constexpr const char *P_RAW_APPLIED_KNOB = "_knob:"; /* followed by knob path */
 
 constexpr const char *P_COMMAND = "command";
 constexpr const char *P_USER = "user";
@@ -25,17 +26,21 @@ constexpr const char *P_STDERR_PATH = "stderr_path";
 constexpr const char *P_STDOUT_LIMIT = "stdout_limit";
 constexpr const char *P_MEM_GUARANTEE = "memory_guarantee";
 constexpr const char *P_MEM_LIMIT = "memory_limit";
+constexpr const char *P_MEM_HIGH_LIMIT = "memory_high";
 constexpr const char *P_DIRTY_LIMIT = "dirty_limit";
 constexpr const char *P_ANON_LIMIT = "anon_limit";
+constexpr const char *P_THREAD_LIMIT = "thread_limit";
 constexpr const char *P_RECHARGE_ON_PGFAULT = "recharge_on_pgfault";
 constexpr const char *P_CPU_POLICY = "cpu_policy";
 constexpr const char *P_CPU_GUARANTEE = "cpu_guarantee";
 constexpr const char *P_CPU_LIMIT = "cpu_limit";
 constexpr const char *P_IO_POLICY = "io_policy";
+constexpr const char *P_IO_WEIGHT = "io_weight";
 constexpr const char *P_IO_LIMIT = "io_limit";
 constexpr const char *P_IO_OPS_LIMIT = "io_ops_limit";
 constexpr const char *P_NET_GUARANTEE = "net_guarantee";
 constexpr const char *P_NET_LIMIT = "net_limit";
+constexpr const char *P_NET_RX_LIMIT = "net_rx_limit";
 constexpr const char *P_NET_PRIO = "net_priority";
 constexpr const char *P_RESPAWN = "respawn";
 constexpr const char *P_MAX_RESPAWNS = "max_respawns";
@@ -65,6 +70,10 @@ constexpr const char *D_STATE = "state";
 constexpr const char *D_OOM_KILLED = "oom_killed";
 constexpr const char *D_PARENT = "parent";
 constexpr const char *D_RESPAWN_COUNT = "respawn_count";
+constexpr const char *D_OOM_COUNT = "oom_count";
+constexpr const char *D_OOM_EVENTS = "oom_events";
+constexpr const char *D_RESPAWN_DELAY = "respawn_delay";
+constexpr const char *D_RESPAWN_ATTEMPTS = "respawn_attempts";
 constexpr const char *D_ROOT_PID = "root_pid";
 constexpr const char *D_EXIT_STATUS = "exit_status";
 constexpr const char *D_START_ERRNO = "start_errno";
@@ -77,8 +86,17 @@ constexpr const char *D_ANON_USAGE = "anon_usage";
 constexpr const char *D_MINOR_FAULTS = "minor_faults";
 constexpr const char *D_MAJOR_FAULTS = "major_faults";
 constexpr const char *D_MAX_RSS = "max_rss";
+constexpr const char *D_MEMORY_STAT = "memory_stat";
+constexpr const char *D_MEMORY_STAT_TOTAL = "memory_stat_total";
+constexpr const char *D_MEMORY_HIGH_EVENTS = "memory_high_events";
+constexpr const char *D_MEMORY_STALL = "memory_stall";
+constexpr const char *D_THREAD_COUNT = "thread_count";
+constexpr const char *D_FORKS_REJECTED = "forks_rejected";
 constexpr const char *D_CPU_USAGE = "cpu_usage";
 constexpr const char *D_CPU_SYSTEM = "cpu_usage_system";
+constexpr const char *D_CPU_THROTTLED = "cpu_throttled";
+constexpr const char *D_CPU_THROTTLED_PERIODS = "cpu_throttled_periods";
+constexpr const char *D_CPU_WAIT = "cpu_wait";
 constexpr const char *D_NET_BYTES = "net_bytes";
 constexpr const char *D_NET_PACKETS = "net_packets";
 constexpr const char *D_NET_DROPS = "net_drops";
@@ -86,9 +104,15 @@ constexpr const char *D_NET_OVERLIMITS = "net_overlimits";
 constexpr const char *D_NET_RX_BYTES = "net_rx_bytes";
 constexpr const char *D_NET_RX_PACKETS = "net_rx_packets";
 constexpr const char *D_NET_RX_DROPS = "net_rx_drops";
+constexpr const char *D_NET_RX_OVERLIMITS = "net_rx_overlimits";
 constexpr const char *D_IO_READ = "io_read";
 constexpr const char *D_IO_WRITE = "io_write";
 constexpr const char *D_IO_OPS = "io_ops";
+constexpr const char *D_IO_TIME = "io_time";
+constexpr const char *D_IO_WAIT = "io_wait";
+constexpr const char *D_IO_QUEUED = "io_queued";
+constexpr const char *D_IO_SHARE = "io_share";
+constexpr const char *D_IO_WEIGHT_SHARE = "io_weight_share";
 constexpr const char *D_TIME = "time";
 constexpr const char *D_PORTO_STAT = "porto_stat";
 constexpr const char *D_MEM_TOTAL_LIMIT = "memory_limit_total";
@@ -147,6 +171,12 @@ constexpr uint64_t OOM_KILLED_SET = (1lu << 54);
 constexpr uint64_t RESPAWN_COUNT_SET = (1lu << 55);
 constexpr uint64_t EXIT_STATUS_SET = (1lu << 56);
 constexpr uint64_t CAPABILITIES_AMBIENT_SET = (1lu << 57);
+constexpr uint64_t THREAD_LIMIT_SET = (1lu << 58);
+constexpr uint64_t NET_RX_LIMIT_SET = (1lu << 59);
+constexpr uint64_t OOM_COUNT_SET = (1lu << 60);
+constexpr uint64_t OOM_EVENTS_SET = (1lu << 61);
+constexpr uint64_t MEM_HIGH_LIMIT_SET = (1lu << 62);
+constexpr uint64_t IO_WEIGHT_SET = (1lu << 63);
 
 constexpr const char *P_VIRT_MODE_APP = "app";
 constexpr const char *P_VIRT_MODE_OS = "os";
@@ -8,6 +8,7 @@
 #include "container.hpp"
 #include "volume.hpp"
 #include "event.hpp"
+#include "statistics.hpp"
 #include "protobuf.hpp"
 #include "util/log.hpp"
 #include "util/string.hpp"
@@ -15,6 +16,8 @@
 
 using std::string;
 
+std::function<void(std::shared_ptr<TContainer>)> RequeueRpcRequests;
+
 static std::string RequestAsString(const rpc::TContainerRequest &req) {
     if (Verbose)
         return req.ShortDebugString();
@@ -92,7 +95,20 @@ static std::string RequestAsString(const rpc::TContainerRequest &req) {
         for (auto p: req.tunevolume().properties())
             ret += " " + p.name() + "=" + p.value();
         return ret;
-    } else if (req.has_convertpath())
+    } else if (req.has_applyspec()) {
+        std::string ret = "apply " + req.applyspec().name();
+        for (auto p: req.applyspec().properties())
+            ret += " " + p.name() + "=" + p.value();
+        for (auto v: req.applyspec().volumes())
+            ret += " volume=" + v;
+        if (req.applyspec().start())
+            ret += " start";
+        return ret;
+    } else if (req.has_checkpoint())
+        return "checkpoint " + req.checkpoint().name() + " to " + req.checkpoint().path();
+    else if (req.has_restore())
+        return "restore " + req.restore().name() + " from " + req.restore().path();
+    else if (req.has_convertpath())
         return "convert " + req.convertpath().path() +
             " from " + req.convertpath().source() +
             " to " + req.convertpath().destination();
@@ -210,6 +226,9 @@ static std::string ResponseAsString(const rpc::TContainerResponse &resp) {
     case EError::NoSpace:
         return "Error: NoSpace (" + resp.errormsg() + ")";
         break;
+    case EError::Throttled:
+        return "Error: Throttled (" + resp.errormsg() + ")";
+        break;
     default:
         return resp.ShortDebugString();
         break;
@@ -261,7 +280,10 @@ static bool ValidRequest(const rpc::TContainerRequest &req) {
         req.has_exportlayer() +
         req.has_removelayer() +
         req.has_listlayers() +
-        req.has_convertpath() == 1;
+        req.has_convertpath() +
+        req.has_applyspec() +
+        req.has_checkpoint() +
+        req.has_restore() == 1;
 }
 
 static void SendReply(std::shared_ptr<TClient> client,
@@ -284,12 +306,11 @@ static TError CheckPortoWriteAccess(std::shared_ptr<TClient> client) {
     return TError::Success();
 }
 
-static noinline TError CreateContainer(TContext &context,
-                                std::string reqName, bool weak,
-                                rpc::TContainerResponse &rsp,
-                                std::shared_ptr<TClient> client) {
-    auto holder_lock = LockContainers();
-
+static TError CreateContainerLocked(TContext &context,
+                                    TScopedLock &holder_lock,
+                                    const std::string &reqName,
+                                    std::shared_ptr<TClient> client,
+                                    std::shared_ptr<TContainer> &container) {
     TError err = CheckPortoWriteAccess(client);
     if (err)
         return err;
@@ -310,8 +331,17 @@ static noinline TError CreateContainer(TContext &context,
     if (parent->IsAcquired())
         return TError(EError::Busy, "Parent container " + parent->GetName() + " is busy");
 
+    return context.Cholder->Create(holder_lock, name, client->Cred, container);
+}
+
+static noinline TError CreateContainer(TContext &context,
+                                std::string reqName, bool weak,
+                                rpc::TContainerResponse &rsp,
+                                std::shared_ptr<TClient> client) {
+    auto holder_lock = LockContainers();
+
     std::shared_ptr<TContainer> container;
-    err = context.Cholder->Create(holder_lock, name, client->Cred, container);
+    TError err = CreateContainerLocked(context, holder_lock, reqName, client, container);
 
     if (!err && weak) {
         container->IsWeak = true;
@@ -367,19 +397,19 @@ noinline TError DestroyContainer(TContext &context,
     return TError::Success();
 }
 
-noinline TError StartContainer(TContext &context,
-                               const rpc::TContainerStartRequest &req,
-                               rpc::TContainerResponse &rsp,
-                               std::shared_ptr<TClient> client) {
-    auto holder_lock = LockContainers();
-
+/* held - container already acquired by caller, if any */
+static TError StartContainerLocked(TContext &context,
+                                   TScopedLock &holder_lock,
+                                   const std::string &reqName,
+                                   std::shared_ptr<TClient> client,
+                                   std::shared_ptr<TContainer> held) {
     TError err = CheckPortoWriteAccess(client);
     if (err)
         return err;
 
     /* Check if target container exists */
     std::string name;
-    err = client->ResolveRelativeName(req.name(), name);
+    err = client->ResolveRelativeName(reqName, name);
     if (err)
         return err;
 
@@ -391,7 +421,7 @@ noinline TError StartContainer(TContext &context,
     std::vector<std::string> nameVec;
     err = SplitString(name, '/', nameVec);
     if (err)
-        return TError(EError::InvalidValue, "Invalid container name " + req.name());
+        return TError(EError::InvalidValue, "Invalid container name " + reqName);
 
     std::shared_ptr<TContainer> topContainer = nullptr;
 
@@ -419,7 +449,7 @@ noinline TError StartContainer(TContext &context,
         if (!topContainer) {
             topContainer = container;
 
-            if (!topContainer->Acquire())
+            if (topContainer != held && !topContainer->Acquire())
                 return TError(EError::Busy, "Can't start busy container " + topContainer->GetName());
         }
 
@@ -447,12 +477,20 @@ noinline TError StartContainer(TContext &context,
     }
 
 release:
-    if (topContainer)
+    if (topContainer && topContainer != held)
         topContainer->Release();
 
     return err;
 }
 
+noinline TError StartContainer(TContext &context,
+                               const rpc::TContainerStartRequest &req,
+                               rpc::TContainerResponse &rsp,
+                               std::shared_ptr<TClient> client) {
+    auto holder_lock = LockContainers();
+    return StartContainerLocked(context, holder_lock, req.name(), client, nullptr);
+}
+
 noinline TError StopContainer(TContext &context,
                               const rpc::TContainerStopRequest &req,
                               rpc::TContainerResponse &rsp,
@@ -530,7 +568,17 @@ noinline TError ListContainers(TContext &context,
                                std::shared_ptr<TClient> client) {
     auto holder_lock = LockContainers();
 
-    for (auto &c : context.Cholder->List()) {
+    std::shared_ptr<TContainer> clientContainer;
+    TError error = client->GetClientContainer(clientContainer);
+    if (error)
+        return error;
+
+    /* Visit only own namespace, root is visible from everywhere */
+    std::string ns = clientContainer->GetPortoNamespace();
+    if (ns != "")
+        rsp.mutable_list()->add_name(ROOT_CONTAINER);
+
+    for (auto &c : context.Cholder->List(false, ns)) {
         std::string name;
         if (!client->ComposeRelativeName(*c, name))
             rsp.mutable_list()->add_name(name);
@@ -652,20 +700,20 @@ noinline TError GetContainerCombined(TContext &context,
 
         std::string name;
         std::shared_ptr<TContainer> container;
+        bool busy = false;
 
         TNestedScopedLock lock;
         TError containerError = client->ResolveRelativeName(relname, name, true);
         if (!containerError) {
             containerError = context.Cholder->Get(name, container);
             if (!containerError && container) {
-                if (container->IsAcquired()) {
-                    containerError = TError(EError::Busy, "Can't get data and property of busy container");
-                } else {
+                busy = container->IsAcquired();
+                if (!busy) {
                     lock = TNestedScopedLock(*container, holder_lock);
                     if (!container->IsValid())
                         containerError = TError(EError::ContainerDoesNotExist, "container doesn't exist");
-                    else if (container->IsAcquired())
-                        containerError = TError(EError::Busy, "Can't get data and property of busy container");
+                    else
+                        busy = container->IsAcquired();
                 }
             }
         }
@@ -677,7 +725,9 @@ noinline TError GetContainerCombined(TContext &context,
             std::string value;
 
             TError error = containerError;
-            if (!error && container)
+            if (!error && container && busy)
+                error = container->GetSnapshotProperty(var, value);
+            else if (!error && container)
                 error = container->GetProperty(var, value, client);
 
             keyval->set_variable(var);
@@ -833,22 +883,33 @@ noinline TError Wait(TContext &context,
     }
 
     if (!waiter->Wildcards.empty()) {
-        for (auto &container : context.Cholder->List()) {
-            if (container->IsRoot() || container->IsPortoRoot())
-                continue;
-
-            /* Wildcard notifies immediately only dead and hollow meta */
-            auto state = container->GetState();
-            if (state != EContainerState::Dead &&
-                (state != EContainerState::Meta ||
-                 container->GetRunningChildren()))
-                continue;
+        std::shared_ptr<TContainer> clientContainer;
+        TError err = client->GetClientContainer(clientContainer);
+        if (err)
+            return err;
 
-            std::string name;
-            if (!client->ComposeRelativeName(*container, name) &&
-                    waiter->MatchWildcard(name)) {
-                rsp.mutable_wait()->set_name(name);
-                return TError::Success();
+        for (auto &wildcard: waiter->Wildcards) {
+            /* Scan only names with the same literal prefix */
+            std::string prefix = clientContainer->GetPortoNamespace() +
+                wildcard.substr(0, wildcard.find_first_of("*?[\\"));
+
+            for (auto &container : context.Cholder->List(false, prefix)) {
+                if (container->IsRoot() || container->IsPortoRoot())
+                    continue;
+
+                /* Wildcard notifies immediately only dead and hollow meta */
+                auto state = container->GetState();
+                if (state != EContainerState::Dead &&
+                    (state != EContainerState::Meta ||
+                     container->GetRunningChildren()))
+                    continue;
+
+                std::string name;
+                if (!client->ComposeRelativeName(*container, name) &&
+                        waiter->MatchWildcard(name)) {
+                    rsp.mutable_wait()->set_name(name);
+                    return TError::Success();
+                }
             }
         }
 
@@ -1111,6 +1172,39 @@ noinline TError TuneVolume(TContext &context,
     return volume->Tune(*context.Vholder, properties);
 }
 
+static TError LinkContainerVolume(TContext &context,
+                                  std::shared_ptr<TClient> client,
+                                  std::shared_ptr<TContainer> clientContainer,
+                                  std::shared_ptr<TContainer> container,
+                                  const std::string &path) {
+    TPath volume_path = clientContainer->RootPath() / path;
+
+    auto vholder_lock = context.Vholder->ScopedLock();
+    auto volume = context.Vholder->Find(volume_path);
+
+    if (!volume)
+        return TError(EError::VolumeNotFound, "Volume not found");
+    vholder_lock.unlock();
+
+    auto volume_lock = volume->ScopedLock();
+    if (!volume->IsReady)
+        return TError(EError::Busy, "Volume not ready");
+
+    TError error = volume->CheckPermission(client->Cred);
+    if (error)
+        return error;
+
+    vholder_lock.lock();
+    auto link = std::find(container->Volumes.begin(), container->Volumes.end(), volume);
+    if (link != container->Volumes.end())
+        return TError(EError::VolumeAlreadyLinked, "Already linked");
+
+    if (!container->VolumeHolder)
+        container->VolumeHolder = context.Vholder;
+    container->Volumes.emplace_back(volume);
+    return volume->LinkContainer(container->GetName());
+}
+
 noinline TError LinkVolume(TContext &context,
                            const rpc::TVolumeLinkRequest &req,
                            rpc::TContainerResponse &rsp,
@@ -1144,32 +1238,7 @@ noinline TError LinkVolume(TContext &context,
     }
     cholder_lock.unlock();
 
-    TPath volume_path = clientContainer->RootPath() / req.path();
-
-    auto vholder_lock = context.Vholder->ScopedLock();
-    auto volume = context.Vholder->Find(volume_path);
-
-    if (!volume)
-        return TError(EError::VolumeNotFound, "Volume not found");
-    vholder_lock.unlock();
-
-    auto volume_lock = volume->ScopedLock();
-    if (!volume->IsReady)
-        return TError(EError::Busy, "Volume not ready");
-
-    error = volume->CheckPermission(client->Cred);
-    if (error)
-        return error;
-
-    vholder_lock.lock();
-    auto link = std::find(container->Volumes.begin(), container->Volumes.end(), volume);
-    if (link != container->Volumes.end())
-        return TError(EError::VolumeAlreadyLinked, "Already linked");
-
-    if (!container->VolumeHolder)
-        container->VolumeHolder = context.Vholder;
-    container->Volumes.emplace_back(volume);
-    return volume->LinkContainer(container->GetName());
+    return LinkContainerVolume(context, client, clientContainer, container, req.path());
 }
 
 noinline TError UnlinkVolume(TContext &context,
@@ -1354,13 +1423,35 @@ noinline TError ImportLayer(TContext &context,
     }
     vholder_lock.unlock();
 
-    error = UnpackTarball(tarball, layer_tmp);
-    if (error)
-        goto err;
+    {
+        std::vector<std::string> whiteouts;
+        uint64_t size = 0, start = GetCurrentTimeMs(), extracted;
+        struct stat st;
+
+        if (!tarball.StatFollow(st))
+            size = st.st_size;
+
+        /* Collect whiteouts while tar extracts, no extra walk over layer */
+        error = UnpackTarball(tarball, layer_tmp, [&](const std::string &name) {
+            std::string base = TPath(name).NormalPath().BaseName();
+            if (base.compare(0, 4, ".wh.") == 0)
+                whiteouts.push_back(name);
+        });
+        if (error)
+            goto err;
 
-    error = SanitizeLayer(layer_tmp, req.merge());
-    if (error)
-        goto err;
+        extracted = GetCurrentTimeMs();
+
+        error = SanitizeLayerWhiteouts(layer_tmp, whiteouts, req.merge());
+        if (error)
+            goto err;
+
+        L_ACT() << "Import layer " << layer_name << " extract " << size
+                << " bytes in " << extracted - start << " ms ("
+                << size / 1000 / std::max(extracted - start, (uint64_t)1)
+                << " MB/s), " << whiteouts.size() << " whiteouts in "
+                << GetCurrentTimeMs() - extracted << " ms" << std::endl;
+    }
 
     error = layer_tmp.Rename(layer);
 
@@ -1455,12 +1546,380 @@ noinline TError ListLayers(TContext &context,
     return error;
 }
 
+static void DestroySpecContainer(TContext &context, TScopedLock &holder_lock,
+                                 std::shared_ptr<TContainer> container) {
+    TNestedScopedLock lock(*container, holder_lock);
+    if (!container->IsValid())
+        return;
+
+    TError error = context.Cholder->Destroy(holder_lock, container);
+    if (error)
+        L_WRN() << "Cannot rollback " << container->GetName() << " : " << error << std::endl;
+}
+
+/*
+ * Creates container, applies properties with single save, links volumes
+ * and optionally starts it. Container is busy until configured and started
+ * and destroyed if any step fails.
+ */
+noinline TError ApplyContainerSpec(TContext &context,
+                                   const rpc::TContainerSpecRequest &req,
+                                   rpc::TContainerResponse &rsp,
+                                   std::shared_ptr<TClient> client) {
+    std::vector<std::pair<std::string, std::string>> properties;
+    for (auto &prop: req.properties())
+        properties.emplace_back(prop.name(), prop.value());
+
+    std::shared_ptr<TContainer> clientContainer;
+    TError error = client->GetClientContainer(clientContainer);
+    if (error)
+        return error;
+
+    auto holder_lock = LockContainers();
+
+    std::shared_ptr<TContainer> container;
+    error = CreateContainerLocked(context, holder_lock, req.name(), client, container);
+    if (error)
+        return error;
+
+    /* fresh container, nobody else could acquire it yet */
+    bool acquired = container->Acquire();
+    PORTO_ASSERT(acquired);
+
+    {
+        TNestedScopedLock lock(*container, holder_lock);
+        error = container->SetProperties(properties, client);
+    }
+
+    if (!error && req.volumes_size()) {
+        holder_lock.unlock();
+        for (auto &path: req.volumes()) {
+            error = LinkContainerVolume(context, client, clientContainer, container, path);
+            if (error) {
+                error = TError(error, "Cannot link volume " + path);
+                break;
+            }
+        }
+        holder_lock.lock();
+    }
+
+    if (!error && req.start())
+        error = StartContainerLocked(context, holder_lock, req.name(), client, container);
+
+    if (error)
+        DestroySpecContainer(context, holder_lock, container);
+
+    container->Release();
+
+    return error;
+}
+
+static void ReportPhases(rpc::TContainerResponse &rsp, const TCheckpointPhases &phases) {
+    for (auto &phase: phases) {
+        auto p = rsp.add_phases();
+        p->set_name(phase.first);
+        p->set_time_ms(phase.second);
+    }
+}
+
+noinline TError CheckpointContainer(TContext &context,
+                                    const rpc::TContainerCheckpointRequest &req,
+                                    rpc::TContainerResponse &rsp,
+                                    std::shared_ptr<TClient> client) {
+    auto holder_lock = LockContainers();
+
+    TError error = CheckPortoWriteAccess(client);
+    if (error)
+        return error;
+
+    /* image keeps memory of tasks and restores them with any credentials */
+    if (!client->Cred.IsRootUser())
+        return TError(EError::Permission, "Checkpoint requires root privileges");
+
+    std::shared_ptr<TContainer> container;
+    TNestedScopedLock lock;
+    error = context.Cholder->GetLocked(holder_lock, client, req.name(), true, container, lock);
+    if (error)
+        return error;
+
+    TScopedAcquire acquire(container);
+    if (!acquire.IsAcquired())
+        return TError(EError::Busy, "Can't checkpoint busy container");
+
+    TCheckpointPhases phases;
+    error = container->Checkpoint(holder_lock, req.path(), phases);
+    ReportPhases(rsp, phases);
+
+    return error;
+}
+
+/*
+ * Creates container with properties from checkpoint image or reuses stopped
+ * one left by checkpoint and starts it by restoring dumped tasks.
+ * Container created here is destroyed if restore fails.
+ */
+noinline TError RestoreContainer(TContext &context,
+                                 const rpc::TContainerRestoreRequest &req,
+                                 rpc::TContainerResponse &rsp,
+                                 std::shared_ptr<TClient> client) {
+    if (!client->Cred.IsRootUser())
+        return TError(EError::Permission, "Restore requires root privileges");
+
+    TPath path(req.path());
+    if (!path.IsAbsolute())
+        return TError(EError::InvalidValue, "Checkpoint path must be absolute");
+
+    std::string name;
+    TError error = client->ResolveRelativeName(req.name(), name);
+    if (error)
+        return error;
+
+    TCheckpointPhases phases;
+    uint64_t time = GetCurrentTimeMs();
+
+    std::string imageName;
+    std::vector<int> pids;
+    std::vector<std::pair<std::string, std::string>> properties;
+    error = TContainer::ReadCheckpoint(path, imageName, pids, properties);
+    if (error)
+        return error;
+
+    /* tasks reopen files in working directory of original container */
+    if (imageName != name)
+        return TError(EError::InvalidValue, "Checkpoint image is for container " + imageName);
+
+    phases.emplace_back("load", GetCurrentTimeMs() - time);
+    time = GetCurrentTimeMs();
+
+    auto holder_lock = LockContainers();
+
+    std::shared_ptr<TContainer> container;
+    bool created = false;
+
+    if (context.Cholder->Get(name, container)) {
+        error = CreateContainerLocked(context, holder_lock, req.name(), client, container);
+        if (error)
+            return error;
+        created = true;
+
+        /* fresh container, nobody else could acquire it yet */
+        bool acquired = container->Acquire();
+        PORTO_ASSERT(acquired);
+    } else {
+        error = CheckPortoWriteAccess(client);
+        if (error)
+            return error;
+
+        if (!container->Acquire())
+            return TError(EError::Busy, "Can't restore busy container");
+    }
+
+    {
+        TNestedScopedLock lock(*container, holder_lock);
+        if (container->GetState() != EContainerState::Stopped)
+            error = TError(EError::InvalidState, "invalid container state " +
+                           container->ContainerStateName(container->GetState()));
+        if (!error)
+            error = container->SetProperties(properties, client);
+        container->RestoreImage = path;
+        container->RestorePids = pids;
+    }
+
+    if (!error) {
+        phases.emplace_back("create", GetCurrentTimeMs() - time);
+        time = GetCurrentTimeMs();
+
+        error = StartContainerLocked(context, holder_lock, req.name(), client, container);
+    }
+
+    {
+        TNestedScopedLock lock(*container, holder_lock);
+        container->RestoreImage = TPath();
+        container->RestorePids.clear();
+    }
+
+    if (error) {
+        if (created)
+            DestroySpecContainer(context, holder_lock, container);
+    } else {
+        phases.emplace_back("restore", GetCurrentTimeMs() - time);
+        Statistics->Restores++;
+    }
+
+    container->Release();
+
+    ReportPhases(rsp, phases);
+
+    return error;
+}
+
+static bool QueueableRequest(const rpc::TContainerRequest &req, std::string &name) {
+    if (req.has_start())
+        name = req.start().name();
+    else if (req.has_stop())
+        name = req.stop().name();
+    else if (req.has_destroy())
+        name = req.destroy().name();
+    else if (req.has_pause())
+        name = req.pause().name();
+    else if (req.has_resume())
+        name = req.resume().name();
+    else if (req.has_setproperty())
+        name = req.setproperty().name();
+    else if (req.has_kill())
+        name = req.kill().name();
+    else
+        return false;
+    return true;
+}
+
+/*
+ * New request must not overtake requests already waiting for container
+ * and must not block on lock of acquired one, order of wakeup is random.
+ */
+static bool MustQueue(TContext &context, const rpc::TContainerRequest &req,
+                      std::shared_ptr<TClient> client) {
+    std::string name, absName;
+    std::shared_ptr<TContainer> container;
+
+    if (client->QueueDeadline || !QueueableRequest(req, name))
+        return false;
+
+    auto holder_lock = LockContainers();
+
+    return !client->ResolveRelativeName(name, absName) &&
+           !context.Cholder->Get(absName, container) &&
+           (!container->QueuedRequests.empty() || container->IsAcquired());
+}
+
+/*
+ * Instead of replying Busy put request into queue of target container,
+ * it will be executed again after release in order of arrival.
+ * Head of queue which hits busy container again keeps its position.
+ */
+static TError QueueRequest(TContext &context, const rpc::TContainerRequest &req,
+                           std::shared_ptr<TClient> client, const TError &busy) {
+    std::string name;
+
+    if (!QueueableRequest(req, name) || !RequeueRpcRequests)
+        return busy;
+
+    uint64_t now = GetCurrentTimeMs();
+    if (!client->QueueDeadline) {
+        client->QueueDeadline = now + config().container().request_queue_timeout_ms();
+    } else if (client->QueueDeadline <= now) {
+        Statistics->QueueTimeouts++;
+        return TError(EError::Busy, "Request queue timeout: " + busy.GetMsg());
+    }
+
+    auto holder_lock = LockContainers();
+
+    std::string absName;
+    TError error = client->ResolveRelativeName(name, absName);
+    if (error)
+        return error;
+
+    std::shared_ptr<TContainer> container;
+    error = context.Cholder->Get(absName, container);
+    if (error)
+        return error;
+
+    auto &queue = container->QueuedRequests;
+
+    if (container->QueueDispatched && !queue.empty() && queue.front().Client == client) {
+        /* nothing to wait for, requeue would spin */
+        if (!container->IsAcquired() && !container->HasAcquiredChild())
+            return busy;
+        queue.front().Requeued = true;
+    } else {
+        if (queue.size() >= config().container().request_queue_size())
+            return TError(EError::Busy, "Request queue is full: " + busy.GetMsg());
+
+        container->PushQueuedRequest({&context, client, req, false});
+        Statistics->QueuedRequests++;
+
+        if (Verbose)
+            L() << "Queue request from " << *client << " for " << absName << std::endl;
+    }
+
+    if (!container->IsAcquired() && !container->HasAcquiredChild()) {
+        /* released while we were here */
+        container->ScheduleQueuedRequests();
+    } else {
+        TEvent e(EEventType::RequestTimeout, container);
+        context.Queue->Add(client->QueueDeadline - now, e);
+    }
+
+    return TError::Queued();
+}
+
+void HandleQueuedRequests(std::shared_ptr<TContainer> container) {
+    auto holder_lock = LockContainers();
+    auto &queue = container->QueuedRequests;
+
+    while (!queue.empty() && !container->IsAcquired() && !container->HasAcquiredChild()) {
+        /* head stays in queue: newcomers cannot overtake it */
+        auto &head = queue.front();
+
+        holder_lock.unlock();
+        if (head.Client->GetFd() >= 0)
+            HandleRpcRequest(*head.Context, head.Request, head.Client);
+        holder_lock.lock();
+
+        if (head.Requeued)
+            head.Requeued = false;
+        else
+            container->EraseQueuedRequest(queue.begin());
+    }
+
+    container->QueueDispatched = false;
+}
+
+void ExpireQueuedRequests(std::shared_ptr<TContainer> container) {
+    auto &queue = container->QueuedRequests;
+    uint64_t now = GetCurrentTimeMs();
+    auto it = queue.begin();
+
+    /* head is being executed right now */
+    if (container->QueueDispatched && it != queue.end())
+        it++;
+
+    while (it != queue.end()) {
+        if (it->Client->QueueDeadline > now) {
+            it++;
+            continue;
+        }
+
+        rpc::TContainerResponse rsp;
+        rsp.set_error(EError::Busy);
+        rsp.set_errormsg("Request queue timeout: container " + container->GetName() + " is busy");
+        it->Client->QueueDeadline = 0;
+        Statistics->QueueTimeouts++;
+        SendReply(it->Client, rsp, true);
+        it = container->EraseQueuedRequest(it);
+    }
+}
+
+bool ThrottleRpcRequest(std::shared_ptr<TClient> client) {
+    TError error = client->AcquireRequest();
+    if (!error)
+        return false;
+
+    rpc::TContainerResponse rsp;
+    client->BeginRequest();
+    rsp.set_error(error.GetError());
+    rsp.set_errormsg(error.GetMsg());
+    SendReply(client, rsp, Verbose);
+    return true;
+}
+
 void HandleRpcRequest(TContext &context, const rpc::TContainerRequest &req,
                       std::shared_ptr<TClient> client) {
     rpc::TContainerResponse rsp;
     string str;
 
-    client->BeginRequest();
+    if (!client->QueueDeadline)
+        client->BeginRequest();
 
     bool log = Verbose || !InfoRequest(req);
     if (log) {
@@ -1480,7 +1939,9 @@ void HandleRpcRequest(TContext &context, const rpc::TContainerRequest &req,
         if (!ValidRequest(req)) {
             L_ERR() << "Invalid request " << req.ShortDebugString() << " from " << *client << std::endl;
             error = TError(EError::InvalidMethod, "invalid request");
-        } else if (req.has_create())
+        } else if (MustQueue(context, req, client))
+            error = TError(EError::Busy, "Container is busy");
+        else if (req.has_create())
             error = CreateContainer(context, req.create().name(), false, rsp, client);
         else if (req.has_createweak())
             error = CreateContainer(context, req.createweak().name(), true, rsp, client);
@@ -1536,6 +1997,12 @@ void HandleRpcRequest(TContext &context, const rpc::TContainerRequest &req,
             error = ListLayers(context, rsp);
         else if (req.has_convertpath())
             error = ConvertPath(context, req.convertpath(), rsp, client);
+        else if (req.has_applyspec())
+            error = ApplyContainerSpec(context, req.applyspec(), rsp, client);
+        else if (req.has_checkpoint())
+            error = CheckpointContainer(context, req.checkpoint(), rsp, client);
+        else if (req.has_restore())
+            error = RestoreContainer(context, req.restore(), rsp, client);
         else
             error = TError(EError::InvalidMethod, "invalid RPC method");
     } catch (std::bad_alloc exc) {
@@ -1552,7 +2019,11 @@ void HandleRpcRequest(TContext &context, const rpc::TContainerRequest &req,
         error = TError(EError::Unknown, "unknown error");
     }
 
+    if (error.GetError() == EError::Busy)
+        error = QueueRequest(context, req, client, error);
+
     if (error.GetError() != EError::Queued) {
+        client->QueueDeadline = 0;
         rsp.set_error(error.GetError());
         rsp.set_errormsg(error.GetMsg());
         SendReply(client, rsp, log);
@@ -1,8 +1,32 @@
 #pragma once
 
+#include <list>
+#include <functional>
+
 #include "common.hpp"
 #include "context.hpp"
 #include "client.hpp"
 
+class TContainer;
+
+struct TQueuedRequest {
+    TContext *Context;
+    std::shared_ptr<TClient> Client;
+    rpc::TContainerRequest Request;
+    bool Requeued;
+};
+
+/* Schedules HandleQueuedRequests, set by owner of rpc workers */
+extern std::function<void(std::shared_ptr<TContainer>)> RequeueRpcRequests;
+
+/* Executes queue of container in order until it's empty or busy again */
+void HandleQueuedRequests(std::shared_ptr<TContainer> container);
+
+/* Replies Busy to requests waiting in queue longer than allowed */
+void ExpireQueuedRequests(std::shared_ptr<TContainer> container);
+
+/* Replies Throttled if client is over its limits, must not hold workers */
+bool ThrottleRpcRequest(std::shared_ptr<TClient> client);
+
 void HandleRpcRequest(TContext &context, const rpc::TContainerRequest &req,
                       std::shared_ptr<TClient> client);
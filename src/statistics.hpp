@@ -20,6 +20,20 @@ struct TStatistics {
     std::atomic<uint64_t> Containers;
     std::atomic<uint64_t> Volumes;
     std::atomic<uint64_t> Clients;
+    std::atomic<uint64_t> Respawned;
+    std::atomic<uint64_t> RespawnThrottled;
+    std::atomic<uint64_t> QueuedRequests;
+    std::atomic<uint64_t> QueueTimeouts;
+    std::atomic<uint64_t> ReconcilePasses;
+    std::atomic<uint64_t> ReconcileSynced;
+    std::atomic<uint64_t> CgroupDiscrepancies;
+    std::atomic<uint64_t> CgroupRepairs;
+    std::atomic<uint64_t> HierarchyMismatches;
+    std::atomic<uint64_t> CgroupWritesSkipped;
+    std::atomic<uint64_t> RequestsThrottled;
+    std::atomic<uint64_t> ContainersOom;
+    std::atomic<uint64_t> Checkpoints;
+    std::atomic<uint64_t> Restores;
 };
 
 extern TStatistics *Statistics;
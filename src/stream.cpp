@@ -1,6 +1,7 @@
 #include "stream.hpp"
 #include "config.hpp"
 #include "util/log.hpp"
+#include "util/unix.hpp"
 #include "client.hpp"
 
 extern "C" {
@@ -108,10 +109,10 @@ TError TStdStream::OpenInChild(const TCred &cred) const {
     return error;
 }
 
-TError TStdStream::Rotate(off_t limit, off_t &loss) const {
+TError TStdStream::Rotate(off_t limit, off_t &loss, bool copy) const {
     loss = 0;
     if (PathOnHost.IsRegularStrict())
-        return PathOnHost.RotateLog(config().container().max_log_size(), loss);
+        return PathOnHost.RotateLog(config().container().max_log_size(), loss, copy);
     return TError::Success();
 }
 
@@ -126,6 +127,51 @@ TError TStdStream::Cleanup() {
     return TError::Success();
 }
 
+/*
+ * Checkpoint keeps managed logs because they are removed at stop
+ * but restored tasks reopen them by path and expect the same size.
+ */
+static TError CopyLog(const TPath &from, const TPath &to) {
+    int status;
+    TError error = Run({ "cp", "--sparse=always", from.ToString(), to.ToString() }, status);
+    if (!error && status)
+        error = TError(EError::Unknown, "Can't execute cp " + std::to_string(status));
+    return error;
+}
+
+TError TStdStream::SaveTo(const TPath &path) const {
+    if (ManagedByPorto && Stream && PathOnHost.IsRegularStrict())
+        return CopyLog(PathOnHost, path);
+    return TError::Success();
+}
+
+TError TStdStream::LoadFrom(const TPath &path) const {
+    if (ManagedByPorto && Stream && path.IsRegularStrict())
+        return CopyLog(path, PathOnHost);
+    return TError::Success();
+}
+
+/* Offset of the oldest byte still stored in the log */
+TError TStdStream::GetOffset(uint64_t base, uint64_t &offset) const {
+    offset = base;
+
+    if (!PathOnHost.IsRegularStrict())
+        return TError::Success();
+
+    int fd = open(PathOnHost.c_str(), O_RDONLY | O_NOCTTY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+        return TError(EError::Unknown, errno, "open(" + PathOnHost.ToString() + ")");
+
+    off_t data = lseek(fd, 0, SEEK_DATA);
+    if (data < 0)
+        data = lseek(fd, 0, SEEK_END);
+    if (data > 0)
+        offset += data;
+
+    close(fd);
+    return TError::Success();
+}
+
 TError TStdStream::Read(std::string &text, off_t limit, uint64_t base, const std::string &start_offset) const {
     uint64_t offset = 0;
     TError error;
@@ -153,12 +199,22 @@ TError TStdStream::Read(std::string &text, off_t limit, uint64_t base, const std
 
     uint64_t size = lseek(fd, 0, SEEK_END);
 
+    /* Head punched out by rotation reads as zeroes */
+    off_t data = lseek(fd, 0, SEEK_DATA);
+    uint64_t first = data < 0 ? size : data;
+
+    if (start_offset == "") {
+        offset = size > first + limit ? size - limit : first;
+    } else if (offset < first) {
+        close(fd);
+        return TError(EError::InvalidData,
+                "requested offset lower than current " + std::to_string(base + first));
+    }
+
     if (size <= offset)
         limit = 0;
     else if (size <= offset + limit)
         limit = size - offset;
-    else if (start_offset == "")
-        offset = size - limit;
 
     if (limit) {
         text.resize(limit);
@@ -171,5 +227,5 @@ TError TStdStream::Read(std::string &text, off_t limit, uint64_t base, const std
     }
 
     close(fd);
-    return TError::Success();
+    return error;
 }
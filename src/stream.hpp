@@ -27,9 +27,13 @@ public:
     TError OpenOnHost(const TCred &cred) const; // called in child, but host ns
     TError OpenInChild(const TCred &cred) const; // called before actual execve
 
-    TError Rotate(off_t limit, off_t &loss) const;
+    TError Rotate(off_t limit, off_t &loss, bool copy = false) const;
     TError Cleanup();
 
     TError Read(std::string &text, off_t limit, uint64_t base,
                 const std::string &start_offset = "") const;
+    TError GetOffset(uint64_t base, uint64_t &offset) const;
+
+    TError SaveTo(const TPath &path) const;
+    TError LoadFrom(const TPath &path) const;
 };
@@ -670,6 +670,37 @@ TError TTask::ConfigureChild() {
     return TError::Success();
 }
 
+/* Simulation: no isolation, credentials and limits are left as is */
+TError TTask::SimulateChild() {
+    TError error;
+
+    if (setsid() < 0)
+        return TError(EError::Unknown, errno, "setsid()");
+
+    umask(0);
+
+    /* simulated cgroups don't inherit membership on fork */
+    for (auto &cg : Env->Cgroups) {
+        error = cg.Attach(getpid());
+        if (error)
+            return error;
+    }
+
+    error = Env->Cwd.Chdir();
+    if (error)
+        return error;
+
+    error = Env->Stdin.OpenInChild(Env->Cred);
+    if (error)
+        return error;
+
+    error = Env->Stdout.OpenInChild(Env->Cred);
+    if (error)
+        return error;
+
+    return Env->Stderr.OpenInChild(Env->Cred);
+}
+
 TError TTask::WaitAutoconf() {
     if (Env->Autoconf.empty())
         return TError::Success();
@@ -700,13 +731,18 @@ void TTask::StartChild() {
     TError error;
 
     /* WPid reported by parent */
-    Env->ReportStage++;
+    if (!Env->Simulate)
+        Env->ReportStage++;
 
     /* Wait for report WPid in parent */
     error = Env->Sock.RecvZero();
     if (error)
         Abort(error);
 
+    /* Unprivileged parent cannot pass foreign pid, report WPid itself */
+    if (Env->Simulate)
+        ReportPid(getpid());
+
     /* Report VPid in pid namespace we're enter */
     if (!Env->Isolate)
         ReportPid(getpid());
@@ -714,7 +750,10 @@ void TTask::StartChild() {
         Env->ReportStage++;
 
     /* Apply configuration */
-    error = ConfigureChild();
+    if (Env->Simulate)
+        error = SimulateChild();
+    else
+        error = ConfigureChild();
     if (error)
         Abort(error);
 
@@ -790,9 +829,11 @@ TError TTask::Start() {
             Abort(error);
 
         /* Enter parent namespaces */
-        error = Env->ParentNs.Enter();
-        if (error)
-            Abort(error);
+        if (!Env->Simulate) {
+            error = Env->ParentNs.Enter();
+            if (error)
+                Abort(error);
+        }
 
         if (Env->TripleFork) {
             /*
@@ -834,7 +875,9 @@ TError TTask::Start() {
         }
 
         /* Report WPid in host pid namespace */
-        if (Env->TripleFork)
+        if (Env->Simulate)
+            Env->ReportStage++;
+        else if (Env->TripleFork)
             ReportPid(GetTid());
         else
             ReportPid(clonePid);
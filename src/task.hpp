@@ -62,6 +62,7 @@ struct TTaskEnv : public TNonCopyable {
     bool NewMountNs;
     std::vector<TCgroup> Cgroups;
     TCred OwnerCred, Cred;
+    bool Simulate = false;
 
     TUnixSocket Sock, MasterSock;
     TUnixSocket Sock2,  MasterSock2;
@@ -106,6 +107,7 @@ public:
     TError ChildApplyLimits();
     TError ChildSetHostname();
     TError ConfigureChild();
+    TError SimulateChild();
     TError WaitAutoconf();
     void StartChild();
     void Restore(std::vector<int> pids);
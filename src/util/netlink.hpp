@@ -48,6 +48,7 @@ enum class ETclassStat {
     RxPackets,
     RxBytes,
     RxDrops,
+    RxOverlimits,
 };
 
 uint32_t TcHandle(uint16_t maj, uint16_t min);
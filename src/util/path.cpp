@@ -620,9 +620,17 @@ TError TPath::SetXAttr(const std::string name, const std::string value) const {
 #define FALLOC_FL_COLLAPSE_RANGE        0x08
 #endif
 
-TError TPath::RotateLog(off_t max_disk_usage, off_t &loss) const {
+/*
+ * Drops head of log and keeps recent output, loss is how far head moved.
+ * Without collapse punched out head keeps offsets and reads as hole.
+ * Without both returns NotSupported unless copy is set: then tail is
+ * moved to the head and caller must hold writers meanwhile.
+ */
+TError TPath::RotateLog(off_t max_disk_usage, off_t &loss, bool copy) const {
     struct stat st;
     off_t hole_len;
+    std::string tail;
+    ssize_t len;
     TError error;
     int fd;
 
@@ -638,17 +646,54 @@ TError TPath::RotateLog(off_t max_disk_usage, off_t &loss) const {
     if (fd < 0)
         return TError(EError::Unknown, errno, "open(" + Path + ")");
 
-    /* Keep half of allowed size or trucate to zero */
+    /* Keep half of allowed size, drop whole blocks in front of it */
     hole_len = st.st_size - max_disk_usage / 2;
     hole_len -= hole_len % st.st_blksize;
+    if (hole_len <= 0)
+        goto out;
+
     loss = hole_len;
+    if (!fallocate(fd, FALLOC_FL_COLLAPSE_RANGE, 0, hole_len))
+        goto out;
 
-    if (fallocate(fd, FALLOC_FL_COLLAPSE_RANGE, 0, hole_len)) {
-        loss = st.st_size;
-        if (ftruncate(fd, 0))
-            error = TError(EError::Unknown, errno, "truncate(" + Path + ")");
+    loss = 0;
+    if (!fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, hole_len))
+        goto out;
+
+    if (!copy) {
+        error = TError(EError::NotSupported, "Cannot collapse or punch " + Path);
+        goto out;
+    }
+
+    tail.resize(st.st_size - hole_len);
+    len = pread(fd, &tail[0], tail.size(), hole_len);
+    if (len < 0) {
+        error = TError(EError::Unknown, errno, "read(" + Path + ")");
+        goto out;
     }
 
+    /* recheck size, output appended since lstat would be cut off */
+    if (fstat(fd, &st)) {
+        error = TError(EError::Unknown, errno, "fstat(" + Path + ")");
+        goto out;
+    }
+
+    if (st.st_size != hole_len + len) {
+        error = TError(EError::Busy, "Log " + Path + " is being written");
+        goto out;
+    }
+
+    if (pwrite(fd, tail.c_str(), len, 0) != len) {
+        error = TError(EError::Unknown, errno, "write(" + Path + ")");
+        goto out;
+    }
+
+    if (ftruncate(fd, len))
+        error = TError(EError::Unknown, errno, "truncate(" + Path + ")");
+    else
+        loss = hole_len;
+
+out:
     close(fd);
     return error;
 }
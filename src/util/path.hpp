@@ -139,7 +139,7 @@ public:
     TError ClearDirectory() const;
     TError StatFS(TStatFS &result) const;
     TError SetXAttr(const std::string name, const std::string value) const;
-    TError RotateLog(off_t max_disk_usage, off_t &loss) const;
+    TError RotateLog(off_t max_disk_usage, off_t &loss, bool copy = false) const;
     TError Chattr(unsigned add_flags, unsigned del_flags) const;
 
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mutex>
+#include <algorithm>
+
+#include "common.hpp"
+
+/*
+ * Token bucket: Rate tokens per second, at most Burst accumulated.
+ * Zero rate means unlimited.
+ */
+class TTokenBucket : public TNonCopyable {
+private:
+    std::mutex Mutex;
+    uint64_t Rate = 0;
+    uint64_t Burst = 1;
+    double Tokens = 0;
+    uint64_t Stamp = 0;
+
+    void Refill(uint64_t now) {
+        if (now > Stamp)
+            Tokens = std::min(Tokens + (double)(now - Stamp) * Rate / 1000,
+                              (double)Burst);
+        Stamp = now;
+    }
+
+public:
+    void Configure(uint64_t rate, uint64_t burst, uint64_t now) {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Rate = rate;
+        Burst = std::max(burst, (uint64_t)1);
+        Tokens = Burst;
+        Stamp = now;
+    }
+
+    /* Returns zero if token is available or milliseconds until next token */
+    uint64_t Peek(uint64_t now) {
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (!Rate)
+            return 0;
+        Refill(now);
+        if (Tokens >= 1)
+            return 0;
+        return (uint64_t)((1 - Tokens) * 1000 / Rate) + 1;
+    }
+
+    /* Returns zero if token is taken or milliseconds until next token */
+    uint64_t Take(uint64_t now) {
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (!Rate)
+            return 0;
+        Refill(now);
+        if (Tokens >= 1) {
+            Tokens -= 1;
+            return 0;
+        }
+        return (uint64_t)((1 - Tokens) * 1000 / Rate) + 1;
+    }
+
+    /* Take token unconditionally, debt is limited by burst */
+    void Charge(uint64_t now) {
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (!Rate)
+            return;
+        Refill(now);
+        Tokens = std::max(Tokens - 1, -(double)Burst);
+    }
+};
@@ -259,7 +259,8 @@ void CloseFds(int max, const std::set<int> &except, bool openStd) {
     }
 }
 
-TError Run(const std::vector<std::string> &command, int &status, bool stdio) {
+TError Run(const std::vector<std::string> &command, int &status, bool stdio,
+           const std::function<TError()> &child) {
     int pid = fork();
     if (pid < 0) {
         return TError(EError::Unknown, errno, "fork()");
@@ -274,6 +275,8 @@ retry:
         }
     } else {
         SetDieOnParentExit(SIGKILL);
+        if (child && child())
+            _exit(EXIT_FAILURE);
         if (!stdio) {
             CloseFds(-1, {});
             open("/dev/null", O_RDONLY);
@@ -293,6 +296,41 @@ retry:
     return TError::Success();
 }
 
+/* Like Run() but feeds each line of stdout to callback when command exits */
+TError RunLines(const std::vector<std::string> &command, int &status,
+                const std::function<void(const std::string &)> &line) {
+    FILE *f = tmpfile();
+    if (!f)
+        return TError(EError::Unknown, errno, "tmpfile()");
+
+    int fd = fileno(f);
+    TError error = Run(command, status, true, [fd]() -> TError {
+        if (dup2(fd, STDOUT_FILENO) != STDOUT_FILENO)
+            return TError(EError::Unknown, errno, "dup2()");
+        CloseFds(-1, { STDOUT_FILENO });
+        open("/dev/null", O_RDONLY);
+        open("/dev/null", O_WRONLY);
+        return TError::Success();
+    });
+
+    if (!error) {
+        char *buf = nullptr;
+        size_t n = 0;
+        ssize_t len;
+
+        rewind(f);
+        while ((len = getline(&buf, &n, f)) >= 0) {
+            if (len && buf[len - 1] == '\n')
+                len--;
+            line(std::string(buf, len));
+        }
+        free(buf);
+    }
+
+    fclose(f);
+    return error;
+}
+
 TError Popen(const std::string &cmd, std::vector<std::string> &lines) {
     FILE *f = popen(cmd.c_str(), "r");
     if (f == nullptr)
@@ -339,10 +377,54 @@ TError PackTarball(const TPath &tar, const TPath &path) {
     return TError::Success();
 }
 
-TError UnpackTarball(const TPath &tar, const TPath &path) {
+/* Reverts tar --quoting-style=escape */
+static std::string UnescapeTarName(const std::string &name) {
+    std::string res;
+
+    for (size_t i = 0; i < name.size(); i++) {
+        if (name[i] != '\\' || i + 1 == name.size()) {
+            res += name[i];
+            continue;
+        }
+
+        char c = name[++i];
+        if (c >= '0' && c <= '7') {
+            int val = 0, n;
+            for (n = 0; n < 3 && i < name.size() &&
+                        name[i] >= '0' && name[i] <= '7'; n++, i++)
+                val = val * 8 + name[i] - '0';
+            res += (char)val;
+            i--;
+            continue;
+        }
+
+        switch (c) {
+            case 'a': res += '\a'; break;
+            case 'b': res += '\b'; break;
+            case 'f': res += '\f'; break;
+            case 'n': res += '\n'; break;
+            case 'r': res += '\r'; break;
+            case 't': res += '\t'; break;
+            case 'v': res += '\v'; break;
+            default: res += c;
+        }
+    }
+
+    return res;
+}
+
+/* Extracts tarball, reports name of each extracted entry if requested */
+TError UnpackTarball(const TPath &tar, const TPath &path,
+                     const std::function<void(const std::string &)> &entry) {
+    TError error;
     int status;
 
-    TError error = Run({ "tar", "--numeric-owner", "-pxf", tar.ToString(), "-C", path.ToString() }, status);
+    if (entry)
+        error = RunLines({ "tar", "--numeric-owner", "--quoting-style=escape",
+                           "-pxvf", tar.ToString(), "-C", path.ToString() }, status,
+                         [&](const std::string &line) { entry(UnescapeTarName(line)); });
+    else
+        error = Run({ "tar", "--numeric-owner", "-pxf", tar.ToString(), "-C", path.ToString() }, status);
     if (error)
         return error;
 
@@ -46,11 +46,16 @@ public:
 
 TError SetOomScoreAdj(int value);
 
-TError Run(const std::vector<std::string> &command, int &status, bool stdio = false);
+/* child is called in forked process before exec, failure aborts it */
+TError Run(const std::vector<std::string> &command, int &status, bool stdio = false,
+           const std::function<TError()> &child = nullptr);
 TError Popen(const std::string &cmd, std::vector<std::string> &lines);
 int GetNumCores();
 TError PackTarball(const TPath &tar, const TPath &path);
-TError UnpackTarball(const TPath &tar, const TPath &path);
+TError RunLines(const std::vector<std::string> &command, int &status,
+                const std::function<void(const std::string &)> &line);
+TError UnpackTarball(const TPath &tar, const TPath &path,
+                     const std::function<void(const std::string &)> &entry = nullptr);
 TError CopyRecursive(const TPath &src, const TPath &dst);
 void DumpMallocInfo();
 
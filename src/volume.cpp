@@ -1660,6 +1660,71 @@ TError SanitizeLayer(TPath layer, bool merge) {
     return TError::Success();
 }
 
+/*
+ * Same as SanitizeLayer but handles only whiteouts reported by tar
+ * during extraction instead of walking through the whole layer.
+ */
+TError SanitizeLayerWhiteouts(const TPath &layer,
+                              const std::vector<std::string> &whiteouts,
+                              bool merge) {
+    TPath root = layer.RealPath();
+    TError error;
+
+    for (auto &name: whiteouts) {
+        TPath inner = TPath(name).NormalPath();
+
+        if (inner.IsAbsolute() || inner.ToString() == "." ||
+                inner.ToString() == ".." ||
+                inner.ToString().compare(0, 3, "../") == 0)
+            continue;
+
+        TPath path = root / inner;
+        TPath dir = path.DirName();
+        std::string entry = path.BaseName();
+
+        /* Parent is already removed or replaced by earlier whiteout */
+        struct stat st;
+        if (dir.StatStrict(st) || (!S_ISDIR(st.st_mode) && !S_ISLNK(st.st_mode)))
+            continue;
+
+        /* Never follow symlinks out of layer */
+        if (!S_ISDIR(st.st_mode) || dir.RealPath() != dir)
+            return TError(EError::InvalidValue, "Whiteout outside of layer: " + name);
+
+        /* Already removed together with parent */
+        if (path.StatStrict(st))
+            continue;
+
+        error = path.RemoveAll();
+        if (error)
+            return error;
+
+        if (entry == ".wh..wh..opq") {
+            error = dir.SetXAttr("trusted.overlay.opaque", "y");
+            if (error)
+                return error;
+        }
+
+        if (entry.compare(0, 8, ".wh..wh.") == 0)
+            continue;
+
+        path = dir / entry.substr(4);
+        if (!path.StatStrict(st)) {
+            error = path.RemoveAll();
+            if (error)
+                return error;
+        }
+
+        if (!merge) {
+            error = path.Mknod(S_IFCHR, 0);
+            if (error)
+                return error;
+        }
+    }
+
+    return TError::Success();
+}
+
 TError TVolume::SetProperty(const std::map<std::string, std::string> &properties) {
     TError error;
 
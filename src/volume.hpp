@@ -45,6 +45,9 @@ class TContainer;
 class TContainerHolder;
 
 TError SanitizeLayer(TPath layer, bool merge);
+TError SanitizeLayerWhiteouts(const TPath &layer,
+                              const std::vector<std::string> &whiteouts,
+                              bool merge);
 
 class TVolumeBackend {
 public:
@@ -39,6 +39,24 @@ static int Stresstest(int argc, char *argv[]) {
     return test::StressTest(threads, iter, killPorto);
 }
 
+static int Respawntest(int argc, char *argv[]) {
+    int containers = 500, seconds = 30;
+    if (argc >= 1)
+        StringToInt(argv[0], containers);
+    if (argc >= 2)
+        StringToInt(argv[1], seconds);
+    std::cout << "Containers: " << containers << " Seconds: " << seconds << std::endl;
+    return test::RespawnTest(containers, seconds);
+}
+
+static int Spectest(int argc, char *argv[]) {
+    int containers = 1000;
+    if (argc >= 1)
+        StringToInt(argv[0], containers);
+    std::cout << "Containers: " << containers << std::endl;
+    return test::SpecTest(containers);
+}
+
 static int Fuzzytest(int argc, char *argv[]) {
     int threads = 32, iter = 1000;
     if (argc >= 1)
@@ -52,6 +70,9 @@ static int Fuzzytest(int argc, char *argv[]) {
 static void Usage() {
     std::cout << "usage: " << program_invocation_short_name << " [--except] <selftest>..." << std::endl;
     std::cout << "       " << program_invocation_short_name << " stress [threads] [iterations] [kill=on/off]" << std::endl;
+    std::cout << "       " << program_invocation_short_name << " respawn [containers] [seconds]" << std::endl;
+    std::cout << "       " << program_invocation_short_name << " spec [containers]" << std::endl;
+    std::cout << "with PORTO_SOCKET set only stress (kill=off), respawn and spec run against portod --simulate" << std::endl;
 }
 
 static int TestConnectivity() {
@@ -97,6 +118,22 @@ int main(int argc, char *argv[])
     try {
         config.Load();
 
+        string what = "";
+        if (argc >= 2)
+            what = argv[1];
+
+        /* simulated portod: no test users, links or kernel features needed */
+        if (getenv("PORTO_SOCKET")) {
+            if (what == "stress" && argc >= 5 && !strcmp(argv[4], "off"))
+                return Stresstest(argc - 2, argv + 2);
+            if (what == "respawn")
+                return Respawntest(argc - 2, argv + 2);
+            if (what == "spec")
+                return Spectest(argc - 2, argv + 2);
+            std::cerr << "Only stress with kill=off, respawn and spec run with PORTO_SOCKET" << std::endl;
+            return EXIT_FAILURE;
+        }
+
         test::InitUsersAndGroups();
 
         auto nl = std::make_shared<TNl>();
@@ -110,12 +147,12 @@ int main(int argc, char *argv[])
 
         test::InitKernelFeatures();
 
-        string what = "";
-        if (argc >= 2)
-            what = argv[1];
-
         if (what == "stress")
             return Stresstest(argc - 2, argv + 2);
+        if (what == "respawn")
+            return Respawntest(argc - 2, argv + 2);
+        if (what == "spec")
+            return Spectest(argc - 2, argv + 2);
         if (what == "fuzzy")
             return Fuzzytest(argc - 2, argv + 2);
         else
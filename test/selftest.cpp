@@ -24,6 +24,7 @@ extern "C" {
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <grp.h>
 #include <linux/capability.h>
 }
@@ -187,6 +188,8 @@ static void ShouldHaveValidProperties(Porto::Connection &api, const string &name
     ExpectEq(v, std::to_string(config().network().default_guarantee()));
     ExpectApiSuccess(api.GetProperty(name, "net_limit[default]", v));
     ExpectEq(v, "0");
+    ExpectApiSuccess(api.GetProperty(name, "net_rx_limit[default]", v));
+    ExpectEq(v, "0");
     ExpectApiSuccess(api.GetProperty(name, "net_priority[default]", v));
     ExpectEq(v, "3");
 
@@ -253,6 +256,15 @@ static void ShouldHaveValidRunningData(Porto::Connection &api, const string &nam
     ExpectApiSuccess(api.GetData(name, "stderr", v));
     ExpectApiSuccess(api.GetData(name, "cpu_usage", v));
     ExpectApiSuccess(api.GetData(name, "memory_usage", v));
+    ExpectApiSuccess(api.GetData(name, "memory_stat", v));
+    ExpectApiSuccess(api.GetData(name, "memory_stat[cache]", v));
+    ExpectApiSuccess(api.GetData(name, "memory_stat_total[failcnt]", v));
+    ExpectApiFailure(api.GetData(name, "memory_stat[__invalid__]", v), EError::InvalidValue);
+
+    if (KernelSupports(KernelFeature::CFS_BANDWIDTH)) {
+        ExpectApiSuccess(api.GetData(name, "cpu_throttled", v));
+        ExpectApiSuccess(api.GetData(name, "cpu_throttled_periods", v));
+    }
 
     if (NetworkEnabled()) {
         ExpectApiSuccess(api.GetData(name, "net_bytes", v));
@@ -263,6 +275,7 @@ static void ShouldHaveValidRunningData(Porto::Connection &api, const string &nam
         ExpectApiSuccess(api.GetData(name, "net_rx_bytes", v));
         ExpectApiSuccess(api.GetData(name, "net_rx_packets", v));
         ExpectApiSuccess(api.GetData(name, "net_rx_drops", v));
+        ExpectApiSuccess(api.GetData(name, "net_rx_overlimits", v));
     }
 
     int intval;
@@ -303,7 +316,10 @@ static void ShouldHaveValidData(Porto::Connection &api, const string &name) {
     ExpectApiFailure(api.GetData(name, "stdout", v), EError::InvalidState);
     ExpectApiFailure(api.GetData(name, "stderr", v), EError::InvalidState);
     ExpectApiFailure(api.GetData(name, "cpu_usage", v), EError::InvalidState);
+    if (KernelSupports(KernelFeature::CPU_WAIT))
+        ExpectApiFailure(api.GetData(name, "cpu_wait", v), EError::InvalidState);
     ExpectApiFailure(api.GetData(name, "memory_usage", v), EError::InvalidState);
+    ExpectApiFailure(api.GetData(name, "memory_stat", v), EError::InvalidState);
 
     if (NetworkEnabled()) {
         ExpectApiFailure(api.GetData(name, "net_bytes", v), EError::InvalidState);
@@ -314,6 +330,7 @@ static void ShouldHaveValidData(Porto::Connection &api, const string &name) {
         ExpectApiFailure(api.GetData(name, "net_rx_bytes", v), EError::InvalidState);
         ExpectApiFailure(api.GetData(name, "net_rx_packets", v), EError::InvalidState);
         ExpectApiFailure(api.GetData(name, "net_rx_drops", v), EError::InvalidState);
+        ExpectApiFailure(api.GetData(name, "net_rx_overlimits", v), EError::InvalidState);
     }
     ExpectApiFailure(api.GetData(name, "minor_faults", v), EError::InvalidState);
     ExpectApiFailure(api.GetData(name, "major_faults", v), EError::InvalidState);
@@ -869,6 +886,18 @@ static void TestExitStatus(Porto::Connection &api) {
     ExpectApiSuccess(api.GetData(name, "oom_killed", ret));
     ExpectEq(ret, string("true"));
 
+    Say() << "Check oom history" << std::endl;
+    ExpectApiSuccess(api.GetData(name, "oom_count", ret));
+    ExpectEq(ret, string("1"));
+    // event has no details if exit of root task came before OOM notification
+    ExpectApiSuccess(api.GetData(name, "oom_events", ret));
+    if (ret != "") {
+        std::vector<std::string> fields;
+        ExpectSuccess(SplitString(ret, ' ', fields));
+        ExpectEq(fields.size(), 5);
+        ExpectEq(fields[4], std::to_string(32 << 20));
+    }
+
     ExpectApiSuccess(api.Destroy(name));
 }
 
@@ -2434,6 +2463,31 @@ static void TestNetProperty(Porto::Connection &api) {
     Expect(linkMap.find("eth0") != linkMap.end());
     ExpectApiSuccess(api.Stop(name));
 
+    Say() << "Check net_rx_limit shapes host side of veth" << std::endl;
+    ExpectApiSuccess(api.SetProperty(name, "command", "sleep 1000"));
+    ExpectApiSuccess(api.SetProperty(name, "net_rx_limit[eth0]", "1000000"));
+    v.clear();
+    ExpectSuccess(Popen("ip -o link show", v));
+    pre = IfHw(v);
+    ExpectApiSuccess(api.Start(name));
+    v.clear();
+    ExpectSuccess(Popen("ip -o link show", v));
+    post = IfHw(v);
+    for (auto kv : pre)
+        post.erase(kv.first);
+    ExpectEq(post.size(), 1);
+    portove = post.begin()->first;
+    ExpectEq(System("tc qdisc show dev " + portove + " | grep -c 'htb 1: root'"), "1");
+    ExpectEq(System("tc class show dev " + portove + " | grep 'htb 1:2 ' | grep -c 'rate 8Mbit'"), "1");
+    ExpectApiSuccess(api.GetData(name, "net_rx_overlimits[eth0]", s));
+
+    ExpectApiSuccess(api.SetProperty(name, "net_rx_limit[eth0]", "2000000"));
+    ExpectEq(System("tc class show dev " + portove + " | grep 'htb 1:2 ' | grep -c 'rate 16Mbit'"), "1");
+
+    ExpectApiSuccess(api.SetProperty(name, "net_rx_limit[eth0]", "0"));
+    ExpectEq(System("tc qdisc show dev " + portove + " | grep -c 'htb' || true"), "0");
+    ExpectApiSuccess(api.Stop(name));
+
     v.clear();
     ExpectSuccess(Popen("ip -o link show", v));
     post = IfHw(v);
@@ -2501,6 +2555,95 @@ static void TestNetProperty(Porto::Connection &api) {
     ExpectApiSuccess(api.Destroy("a"));
 }
 
+static void TestUnifiedCgroups(Porto::Connection &api) {
+    std::string v;
+
+    if (!KernelSupports(KernelFeature::CGROUP2))
+        return;
+
+    Say() << "Check limits are applied in cgroup v2" << std::endl;
+    ExpectApiSuccess(api.Create("a"));
+    ExpectApiSuccess(api.SetProperty("a", "command", "sleep 1000"));
+    ExpectApiSuccess(api.SetProperty("a", "memory_limit", "256M"));
+    ExpectApiSuccess(api.Start("a"));
+    ExpectSuccess(TPath("/sys/fs/cgroup/porto/a/memory.max").ReadAll(v));
+    ExpectEq(StringTrim(v), std::to_string(256 << 20));
+
+    Say() << "Check limit under parent with own tasks is refused" << std::endl;
+    ExpectApiSuccess(api.Create("a/b"));
+    ExpectApiSuccess(api.SetProperty("a/b", "command", "sleep 1000"));
+    ExpectApiSuccess(api.Start("a/b"));
+    ExpectApiSuccess(api.Stop("a/b"));
+    ExpectApiSuccess(api.SetProperty("a/b", "memory_limit", "128M"));
+    ExpectApiFailure(api.Start("a/b"), EError::NotSupported);
+
+    Say() << "Check devices are restricted in cgroup v2" << std::endl;
+    ExpectApiSuccess(api.Create("c"));
+    ExpectApiSuccess(api.SetProperty("c", "devices", "/dev/null r"));
+    ExpectApiSuccess(api.SetProperty("c", "command", "sh -c 'echo > /dev/null'"));
+    ExpectApiSuccess(api.Start("c"));
+    WaitContainer(api, "c");
+    ExpectApiSuccess(api.GetData("c", "exit_status", v));
+    ExpectNeq(v, "0");
+
+    ExpectApiSuccess(api.Destroy("c"));
+    ExpectApiSuccess(api.Destroy("a"));
+}
+
+static void TestThreadLimit(Porto::Connection &api) {
+    std::string v;
+
+    if (!KernelSupports(KernelFeature::PIDS))
+        return;
+
+    Say() << "Check thread_limit rejects forks over limit" << std::endl;
+    ExpectApiSuccess(api.Create("a"));
+    ExpectApiSuccess(api.SetProperty("a", "thread_limit", "10"));
+    ExpectApiSuccess(api.Create("a/b"));
+    ExpectApiSuccess(api.SetProperty("a/b", "command",
+                "sh -c 'for i in $(seq 20); do sleep 1000 & done; sleep 1000'"));
+    ExpectApiSuccess(api.SetProperty("a/b", "isolate", "false"));
+    ExpectApiSuccess(api.Start("a/b"));
+    usleep(500000);
+
+    ExpectApiSuccess(api.GetData("a", "thread_count", v));
+    ExpectEq(v, "10");
+    ExpectApiSuccess(api.GetData("a", "forks_rejected", v));
+    ExpectNeq(v, "0");
+
+    Say() << "Check thread_limit is dynamic" << std::endl;
+    ExpectApiSuccess(api.SetProperty("a", "thread_limit", "0"));
+    ExpectEq(GetCgKnob("pids", "a", "pids.max"), "max");
+
+    ExpectApiSuccess(api.Destroy("a"));
+}
+
+static void TestDevicesProperty(Porto::Connection &api) {
+    std::string ret;
+
+    Say() << "Check device rules shared by containers with same config" << std::endl;
+    for (auto name: { "a", "b" }) {
+        ExpectApiSuccess(api.Create(name));
+        ExpectApiSuccess(api.SetProperty(name, "devices", "/dev/null r"));
+        ExpectApiSuccess(api.SetProperty(name, "command", "sh -c 'head -c 1 /dev/null && echo > /dev/null'"));
+        ExpectApiSuccess(api.Start(name));
+        WaitContainer(api, name);
+        ExpectApiSuccess(api.GetData(name, "exit_status", ret));
+        ExpectNeq(ret, "0");
+    }
+
+    Say() << "Check later device entry overrides earlier one" << std::endl;
+    ExpectApiSuccess(api.Stop("b"));
+    ExpectApiSuccess(api.SetProperty("b", "devices", "/dev/null r; /dev/null rw"));
+    ExpectApiSuccess(api.Start("b"));
+    WaitContainer(api, "b");
+    ExpectApiSuccess(api.GetData("b", "exit_status", ret));
+    ExpectEq(ret, "0");
+
+    ExpectApiSuccess(api.Destroy("a"));
+    ExpectApiSuccess(api.Destroy("b"));
+}
+
 static void TestCapabilitiesProperty(Porto::Connection &api) {
     std::string name = "a";
     std::string pid;
@@ -2967,6 +3110,15 @@ static void TestRoot(Porto::Connection &api) {
     if (KernelSupports(KernelFeature::RECHARGE_ON_PGFAULT))
         properties.push_back("recharge_on_pgfault");
 
+    if (KernelSupports(KernelFeature::PIDS))
+        properties.push_back("thread_limit");
+
+    if (KernelSupports(KernelFeature::MEMORY_HIGH))
+        properties.push_back("memory_high");
+
+    if (KernelSupports(KernelFeature::CFQ))
+        properties.push_back("io_weight");
+
     if (KernelSupports(KernelFeature::FSIO)) {
         properties.push_back("io_limit");
         properties.push_back("io_ops_limit");
@@ -2981,6 +3133,7 @@ static void TestRoot(Porto::Connection &api) {
         */
         properties.push_back("net_guarantee");
         properties.push_back("net_limit");
+        properties.push_back("net_rx_limit");
         properties.push_back("net_priority");
     }
 
@@ -2990,7 +3143,11 @@ static void TestRoot(Porto::Connection &api) {
         "absolute_namespace",
         "state",
         "oom_killed",
+        "oom_count",
+        "oom_events",
         "respawn_count",
+        "respawn_delay",
+        "respawn_attempts",
         "exit_status",
         "start_errno",
         "stdout",
@@ -3000,6 +3157,8 @@ static void TestRoot(Porto::Connection &api) {
         "cpu_usage",
         "cpu_usage_system",
         "memory_usage",
+        "memory_stat",
+        "memory_stat_total",
         "minor_faults",
         "major_faults",
         "io_read",
@@ -3017,11 +3176,36 @@ static void TestRoot(Porto::Connection &api) {
         data.push_back("net_rx_bytes");
         data.push_back("net_rx_packets");
         data.push_back("net_rx_drops");
+        data.push_back("net_rx_overlimits");
     }
 
     if (KernelSupports(KernelFeature::MAX_RSS))
         data.push_back("max_rss");
 
+    if (KernelSupports(KernelFeature::CFS_BANDWIDTH)) {
+        data.push_back("cpu_throttled");
+        data.push_back("cpu_throttled_periods");
+    }
+
+    if (KernelSupports(KernelFeature::CPU_WAIT))
+        data.push_back("cpu_wait");
+
+    if (KernelSupports(KernelFeature::MEMORY_STALL))
+        data.push_back("memory_stall");
+
+    if (KernelSupports(KernelFeature::PIDS)) {
+        data.push_back("thread_count");
+        data.push_back("forks_rejected");
+    }
+
+    if (KernelSupports(KernelFeature::MEMORY_EVENTS))
+        data.push_back("memory_high_events");
+
+    if (KernelSupports(KernelFeature::CFQ)) {
+        data.push_back("io_share");
+        data.push_back("io_weight_share");
+    }
+
     std::vector<Porto::Property> plist;
 
     ExpectApiSuccess(api.Plist(plist));
@@ -3065,6 +3249,14 @@ static void TestRoot(Porto::Connection &api) {
         TestDataMap(api, porto_root, "io_ops", 2);
     }
 
+    if (KernelSupports(KernelFeature::CFQ)) {
+        ExpectApiSuccess(api.GetData(porto_root, "io_time", v));
+        ExpectApiSuccess(api.GetData(porto_root, "io_wait", v));
+        ExpectApiSuccess(api.GetData(porto_root, "io_queued", v));
+        ExpectApiSuccess(api.GetData(porto_root, "io_share", v));
+        ExpectApiSuccess(api.GetData(porto_root, "io_weight_share", v));
+    }
+
     if (NetworkEnabled()) {
         uint32_t defClass = TcHandle(1, 2);
         uint32_t rootClass = TcHandle(1, 1);
@@ -3369,6 +3561,25 @@ static void TestLimits(Porto::Connection &api) {
     ExpectApiSuccess(api.SetProperty(name, "memory_limit", "2g"));
     ExpectApiFailure(api.SetProperty(name, "memory_limit", "10k"), EError::InvalidValue);
 
+    if (KernelSupports(KernelFeature::MEMORY_HIGH)) {
+        Say() << "Check memory_high" << std::endl;
+        ExpectApiFailure(api.SetProperty(name, "memory_high", "3g"), EError::InvalidValue);
+        ExpectApiSuccess(api.SetProperty(name, "memory_high", "1g"));
+        ExpectApiSuccess(api.GetProperty(name, "memory_high", current));
+        ExpectEq(current, "1073741824");
+        if (KernelSupports(KernelFeature::CGROUP2))
+            current = GetCgKnob("memory", name, "memory.high");
+        else
+            current = GetCgKnob("memory", name, "memory.high_limit_in_bytes");
+        ExpectEq(current, "1073741824");
+        if (KernelSupports(KernelFeature::MEMORY_EVENTS))
+            ExpectApiSuccess(api.GetData(name, "memory_high_events", current));
+        ExpectApiFailure(api.SetProperty(name, "memory_limit", "512m"), EError::InvalidValue);
+        ExpectApiSuccess(api.SetProperty(name, "memory_limit", "1g"));
+        ExpectApiSuccess(api.SetProperty(name, "memory_high", "0"));
+        ExpectApiSuccess(api.SetProperty(name, "memory_limit", "2g"));
+    }
+
     ExpectApiSuccess(api.Stop(name));
 
     ExpectApiSuccess(api.SetProperty(name, "memory_limit", "0"));
@@ -3502,6 +3713,22 @@ static void TestLimits(Porto::Connection &api) {
         ExpectSuccess(StringToUint64(GetCgKnob("blkio", name, "blkio.weight"), weight));
         Expect(weight != rootWeight || weight == config().container().batch_io_weight());
         ExpectApiSuccess(api.Stop(name));
+
+        Say() << "Check io_weight" << std::endl;
+        ExpectApiFailure(api.SetProperty(name, "io_weight", "default: 5"), EError::InvalidValue);
+        ExpectApiFailure(api.SetProperty(name, "io_weight", "nodisk: 100"), EError::InvalidValue);
+
+        ExpectApiSuccess(api.SetProperty(name, "io_weight", "default: 300"));
+        ExpectApiSuccess(api.Start(name));
+        ExpectEq(GetCgKnob("blkio", name, "blkio.weight"), "300");
+        ExpectApiSuccess(api.SetProperty(name, "io_weight[default]", "700"));
+        ExpectEq(GetCgKnob("blkio", name, "blkio.weight"), "700");
+        ExpectApiSuccess(api.GetData(name, "io_share", current));
+        ExpectApiSuccess(api.GetData(name, "io_weight_share", current));
+        ExpectApiSuccess(api.Stop(name));
+
+        ExpectApiSuccess(api.SetProperty(name, "io_weight", "default: 0"));
+        ExpectApiSuccess(api.SetProperty(name, "io_policy", "normal"));
     }
 
     if (KernelSupports(KernelFeature::FSIO)) {
@@ -3876,12 +4103,28 @@ static void TestLimitsHierarchy(Porto::Connection &api) {
     ExpectApiFailure(api.SetProperty(slot2, "memory_guarantee", std::to_string(chunk + 1)), EError::ResourceNotAvailable);
     ExpectApiSuccess(api.SetProperty(slot2, "memory_guarantee", std::to_string(chunk)));
 
+    Say() << "Total guarantee follows changes in hierarchy" << std::endl;
+    std::string total_guarantee;
+    ExpectApiSuccess(api.GetProperty(box, "memory_guarantee_total", total_guarantee));
+    ExpectEq(total_guarantee, std::to_string(chunk * 4));
+    ExpectApiSuccess(api.GetProperty(prod, "memory_guarantee_total", total_guarantee));
+    ExpectEq(total_guarantee, std::to_string(chunk * 2));
+
+    ExpectApiSuccess(api.SetProperty(prod, "memory_guarantee", std::to_string(chunk * 3)));
+    ExpectApiSuccess(api.GetProperty(box, "memory_guarantee_total", total_guarantee));
+    ExpectEq(total_guarantee, std::to_string(chunk * 5));
+    ExpectApiSuccess(api.SetProperty(prod, "memory_guarantee", std::to_string(0)));
+
     ExpectApiSuccess(api.SetProperty(monit, "memory_guarantee", std::to_string(0)));
     ExpectApiSuccess(api.SetProperty(system, "memory_guarantee", std::to_string(0)));
+    ExpectApiSuccess(api.GetProperty(box, "memory_guarantee_total", total_guarantee));
+    ExpectEq(total_guarantee, std::to_string(chunk * 2));
 
     ExpectApiSuccess(api.Destroy(monit));
     ExpectApiSuccess(api.Destroy(system));
     ExpectApiSuccess(api.Destroy(slot2));
+    ExpectApiSuccess(api.GetProperty(box, "memory_guarantee_total", total_guarantee));
+    ExpectEq(total_guarantee, std::to_string(chunk));
     ExpectApiSuccess(api.Destroy(slot1));
     ExpectApiSuccess(api.Destroy(prod));
     ExpectApiSuccess(api.Destroy(box));
@@ -4037,6 +4280,9 @@ static void TestLimitsHierarchy(Porto::Connection &api) {
     ExpectNeq(val, "12345");
 
     ExpectApiSuccess(api.Destroy("a"));
+
+    ExpectApiSuccess(api.GetData("/", "porto_stat[hierarchy_mismatches]", val));
+    ExpectEq(val, "0");
 }
 
 static void TestPermissions(Porto::Connection &api) {
@@ -4190,6 +4436,7 @@ static void ReadPropsAndData(Porto::Connection &api, const std::string &name) {
         "default_gw",
         "net_guarantee",
         "net_limit",
+        "net_rx_limit",
         "net_priority",
 
         "net_bytes",
@@ -4199,6 +4446,7 @@ static void ReadPropsAndData(Porto::Connection &api, const std::string &name) {
         "net_rx_bytes",
         "net_rx_packets",
         "net_rx_drops",
+        "net_rx_overlimits",
     };
 
     std::vector<Porto::Property> plist;
@@ -4232,6 +4480,215 @@ static void ReadPropsAndData(Porto::Connection &api, const std::string &name) {
         (void)api.GetData(name, d.Name, v);
 }
 
+static void TestApplySpec(Porto::Connection &api) {
+    std::string name = "a", v;
+    std::vector<std::string> containers;
+
+    Say() << "Check that spec is applied and container is started" << std::endl;
+    ExpectApiSuccess(api.ApplySpec(name, {
+                { "command", "sleep 1000" },
+                { "env", "A=1;B=2" },
+                { "cwd", "/tmp" },
+                { "respawn", "false" },
+            }, {}, true));
+    ExpectApiSuccess(api.GetData(name, "state", v));
+    ExpectEq(v, std::string("running"));
+    ExpectApiSuccess(api.GetProperty(name, "command", v));
+    ExpectEq(v, std::string("sleep 1000"));
+    ExpectApiSuccess(api.GetProperty(name, "cwd", v));
+    ExpectEq(v, std::string("/tmp"));
+    ExpectApiFailure(api.ApplySpec(name, {}), EError::ContainerAlreadyExists);
+    ExpectApiSuccess(api.Destroy(name));
+
+    Say() << "Check that container is not started without start flag" << std::endl;
+    ExpectApiSuccess(api.ApplySpec(name, { { "command", "sleep 1000" } }));
+    ExpectApiSuccess(api.GetData(name, "state", v));
+    ExpectEq(v, std::string("stopped"));
+    ExpectApiSuccess(api.Destroy(name));
+
+    Say() << "Check that invalid spec leaves nothing behind" << std::endl;
+    ExpectApiFailure(api.ApplySpec(name, {
+                { "command", "sleep 1000" },
+                { "max_respawns", "true" },
+            }, {}, true), EError::InvalidValue);
+    ExpectApiFailure(api.GetData(name, "state", v), EError::ContainerDoesNotExist);
+
+    ExpectApiFailure(api.ApplySpec(name, {
+                { "command", "sleep 1000" },
+            }, { "/nonexistent" }), EError::VolumeNotFound);
+    ExpectApiFailure(api.GetData(name, "state", v), EError::ContainerDoesNotExist);
+
+    ExpectApiFailure(api.ApplySpec(name, {
+                { "command", "__invalid_command_name__" },
+                { "cwd", "/" },
+            }, {}, true), EError::InvalidValue);
+    ExpectApiFailure(api.GetData(name, "state", v), EError::ContainerDoesNotExist);
+
+    ExpectApiSuccess(api.List(containers));
+    Expect(std::find(containers.begin(), containers.end(), name) == containers.end());
+}
+
+static void TestCheckpoint(Porto::Connection &api) {
+    std::string name = "a", v, pid;
+    TPath image(TMPDIR + "/checkpoint");
+    std::vector<std::pair<std::string, uint64_t>> phases;
+
+    if (image.Exists())
+        ExpectSuccess(image.RemoveAll());
+
+    Say() << "Check checkpoint and restore errors" << std::endl;
+    ExpectApiSuccess(api.Create(name));
+    ExpectApiFailure(api.Checkpoint(name, image.ToString()), EError::InvalidState);
+    Expect(!image.Exists());
+    ExpectApiFailure(api.Restore(name, image.ToString()), EError::Unknown);
+    ExpectApiSuccess(api.Destroy(name));
+    ExpectApiFailure(api.GetData(name, "state", v), EError::ContainerDoesNotExist);
+
+    if (system("criu check >/dev/null 2>&1")) {
+        Say() << "Skip checkpoint round trip, criu is not available" << std::endl;
+        return;
+    }
+
+    Say() << "Check that restored container keeps tasks and properties" << std::endl;
+    ExpectApiSuccess(api.Create(name));
+    ExpectApiSuccess(api.SetProperty(name, "command", "bash -c 'echo before; sleep 1000'"));
+    ExpectApiSuccess(api.SetProperty(name, "isolate", "false"));
+    ExpectApiSuccess(api.SetProperty(name, "memory_limit", "64M"));
+    ExpectApiSuccess(api.Start(name));
+    ExpectApiSuccess(api.GetData(name, "root_pid", pid));
+    for (int i = 0; i < 100; i++) {
+        ExpectApiSuccess(api.GetData(name, "stdout", v));
+        if (v.size())
+            break;
+        usleep(10000);
+    }
+
+    ExpectApiSuccess(api.Checkpoint(name, image.ToString(), &phases));
+    ExpectEq(phases.size(), 4);
+    ExpectApiSuccess(api.GetData(name, "state", v));
+    ExpectEq(v, std::string("stopped"));
+    ExpectApiSuccess(api.Destroy(name));
+
+    ExpectApiSuccess(api.Restore(name, image.ToString(), &phases));
+    ExpectEq(phases.size(), 3);
+    ExpectApiSuccess(api.GetData(name, "state", v));
+    ExpectEq(v, std::string("running"));
+    ExpectApiSuccess(api.GetData(name, "root_pid", v));
+    ExpectEq(v, pid);
+    ExpectApiSuccess(api.GetProperty(name, "memory_limit", v));
+    ExpectEq(v, std::to_string(64 << 20));
+    ExpectApiSuccess(api.GetData(name, "stdout", v));
+    ExpectEq(v, std::string("before\n"));
+
+    ExpectApiSuccess(api.Kill(name, SIGKILL));
+    WaitContainer(api, name);
+    ExpectApiSuccess(api.Destroy(name));
+    ExpectSuccess(image.RemoveAll());
+}
+
+static uint64_t QueuedRequests(Porto::Connection &api) {
+    std::string v;
+    uint64_t val;
+
+    ExpectApiSuccess(api.GetData("/", "porto_stat[queued_requests]", v));
+    ExpectSuccess(StringToUint64(v, val));
+    return val;
+}
+
+static int ForkRequest(std::function<int(Porto::Connection &)> fn) {
+    int pid = fork();
+    if (pid == 0) {
+        Porto::Connection api2;
+        _exit(fn(api2) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+    return pid;
+}
+
+static void ExpectRequestSuccess(int pid) {
+    int status;
+    ExpectEq(waitpid(pid, &status, 0), pid);
+    ExpectEq(status, 0);
+}
+
+static void TestRequestQueue(Porto::Connection &api) {
+    std::string name = "a", v;
+    std::vector<int> pids;
+
+    ExpectApiSuccess(api.Create(name));
+    ExpectApiSuccess(api.SetProperty(name, "command", "bash -c 'trap \"\" TERM; while true; do sleep 1; done'"));
+    ExpectApiSuccess(api.Start(name));
+
+    Say() << "Check that requests to busy container are executed in arrival order" << std::endl;
+    uint64_t queued = QueuedRequests(api);
+
+    pids.push_back(ForkRequest([&] (Porto::Connection &api) { return api.Stop(name, 3); }));
+    bool busy = false;
+    for (int i = 0; i < 100 && !busy; i++) {
+        std::map<std::string, std::map<std::string, Porto::GetResponse>> result;
+        ExpectApiSuccess(api.Get({name}, {"cpu_usage"}, result));
+        busy = result[name]["cpu_usage"].Error == EError::Busy;
+        if (!busy)
+            usleep(10000);
+    }
+    Expect(busy);
+
+    /* stop is slow, start and stop are queued behind it in this order */
+    pids.push_back(ForkRequest([&] (Porto::Connection &api) { return api.Start(name); }));
+    for (int i = 0; i < 100 && QueuedRequests(api) < queued + 1; i++)
+        usleep(10000);
+    ExpectEq(QueuedRequests(api), queued + 1);
+
+    pids.push_back(ForkRequest([&] (Porto::Connection &api) { return api.Stop(name, 1); }));
+    for (int i = 0; i < 100 && QueuedRequests(api) < queued + 2; i++)
+        usleep(10000);
+    ExpectEq(QueuedRequests(api), queued + 2);
+
+    for (auto pid : pids)
+        ExpectRequestSuccess(pid);
+
+    ExpectApiSuccess(api.GetData(name, "state", v));
+    ExpectEq(v, std::string("stopped"));
+    ExpectApiSuccess(api.Destroy(name));
+}
+
+static void TestBusyGet(Porto::Connection &api) {
+    std::string name = "a", v;
+    std::map<std::string, std::map<std::string, Porto::GetResponse>> result;
+
+    ExpectApiSuccess(api.Create(name));
+    ExpectApiSuccess(api.SetProperty(name, "command", "bash -c 'trap \"\" TERM; while true; do sleep 1; done'"));
+    ExpectApiSuccess(api.Start(name));
+
+    Say() << "Check that combined get of busy container reads committed values" << std::endl;
+    int pid = fork();
+    if (pid == 0) {
+        Porto::Connection api2;
+        _exit(api2.Stop(name, 3) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    bool busy = false;
+    for (int i = 0; i < 100 && !busy; i++) {
+        ExpectApiSuccess(api.Get({name}, {"command", "cpu_usage"}, result));
+        busy = result[name]["cpu_usage"].Error == EError::Busy;
+        if (!busy)
+            usleep(10000);
+    }
+    Expect(busy);
+    ExpectEq(result[name]["command"].Error, 0);
+    ExpectEq(result[name]["command"].Value, "bash -c 'trap \"\" TERM; while true; do sleep 1; done'");
+
+    Say() << "Check that single get of busy container waits instead of Busy" << std::endl;
+    ExpectApiSuccess(api.GetProperty(name, "cwd", v));
+    ExpectApiSuccess(api.GetData(name, "parent", v));
+
+    int status;
+    ExpectEq(waitpid(pid, &status, 0), pid);
+    ExpectEq(status, 0);
+    ExpectApiSuccess(api.GetData(name, "state", v));
+    ExpectEq(v, std::string("stopped"));
+    ExpectApiSuccess(api.Destroy(name));
+}
+
 static void TestLeaks(Porto::Connection &api) {
     string slavePid, masterPid;
     string name;
@@ -4871,6 +5328,38 @@ static void TestRecovery(Porto::Connection &api) {
 
     ExpectApiSuccess(api.Destroy(name));
 
+    Say() << "Make sure recovery doesn't rewrite unchanged cgroup knobs" << std::endl;
+
+    ExpectApiSuccess(api.Create(name));
+    ExpectApiSuccess(api.SetProperty(name, "command", "sleep 1000"));
+    ExpectApiSuccess(api.SetProperty(name, "memory_limit", "256M"));
+    ExpectApiSuccess(api.Start(name));
+
+    KillSlave(api, SIGKILL);
+
+    ExpectApiSuccess(api.GetData(name, "state", v));
+    ExpectEq(v, "running");
+    ExpectApiSuccess(api.GetData("/", "porto_stat[cgroup_writes_skipped]", v));
+    ExpectNeq(v, "0");
+    ExpectApiSuccess(api.GetProperty(name, "memory_limit", v));
+    ExpectEq(v, std::to_string(256 << 20));
+
+    std::string skipped;
+    ExpectApiSuccess(api.SetProperty(name, "memory_limit", "512M"));
+    ExpectApiSuccess(api.GetData("/", "porto_stat[cgroup_writes_skipped]", skipped));
+    ExpectApiSuccess(api.SetProperty(name, "memory_limit", "512M"));
+    ExpectApiSuccess(api.GetData("/", "porto_stat[cgroup_writes_skipped]", v));
+    ExpectNeq(v, skipped);
+
+    KillSlave(api, SIGKILL);
+
+    ExpectApiSuccess(api.GetProperty(name, "memory_limit", v));
+    ExpectEq(v, std::to_string(512 << 20));
+    if (!KernelSupports(KernelFeature::CGROUP2))
+        ExpectEq(GetCgKnob("memory", name, "memory.limit_in_bytes"), std::to_string(512 << 20));
+
+    ExpectApiSuccess(api.Destroy(name));
+
     Say() << "Make sure we don't kill containers when doing recovery" << std::endl;
 
     AsRoot(api);
@@ -5175,9 +5664,43 @@ static void TestCgroups(Porto::Connection &api) {
 
     KillSlave(api, SIGKILL);
 
+    // leftovers are removed by background reconciler
+    for (int i = 0; i < 100; i++) {
+        if (!freezerCg.Exists() && !memoryCg.Exists() && !cpuCg.Exists())
+            break;
+        usleep(100000);
+    }
+
     ExpectEq(freezerCg.Exists(), false);
     ExpectEq(memoryCg.Exists(), false);
     ExpectEq(cpuCg.Exists(), false);
+
+    std::string v;
+    ExpectApiSuccess(api.GetData("/", "porto_stat[cgroup_repairs]", v));
+    ExpectNeq(v, std::string("0"));
+
+    Say() << "Make sure start doesn't reuse populated leftover cgroup" << std::endl;
+
+    ExpectSuccess(freezerCg.MkdirAll(0755));
+
+    pid = fork();
+    if (pid == 0) {
+        ExpectSuccess(TPath(freezerCg + "/cgroup.procs").WriteAll(std::to_string(getpid())));
+        execlp("sleep", "sleep", "1000", nullptr);
+        abort();
+    }
+    for (int i = 0; i < 100; i++) {
+        if (!TPath(freezerCg + "/cgroup.procs").ReadAll(v) && v != "")
+            break;
+        usleep(100000);
+    }
+
+    ExpectApiSuccess(api.Create("asdf"));
+    ExpectApiSuccess(api.SetProperty("asdf", "command", "sleep 1000"));
+    ExpectApiSuccess(api.Start("asdf"));
+    WaitProcessExit(std::to_string(pid));
+    ExpectApiSuccess(api.Destroy("asdf"));
+    ExpectEq(freezerCg.Exists(), false);
 }
 
 static void TestVersion(Porto::Connection &api) {
@@ -5188,6 +5711,53 @@ static void TestVersion(Porto::Connection &api) {
     ExpectEq(revision, PORTO_REVISION);
 }
 
+static void TestRequestLimits(Porto::Connection &api) {
+    TPath conf("/etc/portod.conf");
+    std::string saved, v;
+
+    AsRoot(api);
+    bool existed = conf.Exists();
+    if (existed)
+        ExpectSuccess(conf.ReadAll(saved));
+    else
+        ExpectSuccess(conf.Mkfile(0644));
+
+    Say() << "Check per-user request rate limit" << std::endl;
+    ExpectSuccess(conf.WriteAll(saved + "\ndaemon { client_request_rate: 1 client_request_burst: 2 }\n"));
+    KillSlave(api, SIGKILL);
+
+    AsAlice(api);
+    size_t throttled = 0;
+    for (int i = 0; i < 10; i++) {
+        int ret = api.GetData("/", "state", v);
+        if (ret == EError::Throttled)
+            throttled++;
+        else
+            ExpectApiSuccess(ret);
+    }
+    ExpectLess(0, throttled);
+    ExpectLessEq(throttled, 8);
+
+    AsRoot(api);
+    ExpectApiSuccess(api.GetData("/", "porto_stat[requests_throttled]", v));
+    ExpectEq(v, std::to_string(throttled));
+    // throttling is logged as warning at most once per second
+    ExpectApiSuccess(api.GetData("/", "porto_stat[warnings]", v));
+    expectedWarns = std::stoi(v);
+
+    Say() << "Check throttled requests don't consume tokens" << std::endl;
+    AsAlice(api);
+    usleep(1100 * 1000);
+    ExpectApiSuccess(api.GetData("/", "state", v));
+
+    AsRoot(api);
+    if (existed)
+        ExpectSuccess(conf.WriteAll(saved));
+    else
+        ExpectSuccess(conf.Unlink());
+    KillSlave(api, SIGKILL);
+}
+
 static void TestBadClient(Porto::Connection &api) {
     std::vector<std::string> clist;
     int sec = 120;
@@ -5246,21 +5816,47 @@ static void TestRemoveDead(Porto::Connection &api) {
 }
 
 static void TestLogRotate(Porto::Connection &api) {
-    std::string v;
+    std::string v, offset;
     struct stat st;
 
     std::string name = "biglog";
+    TPath path(TMPDIR + "/" + name);
+
+    /* tmpfs cannot collapse range, head is punched out */
+    RemakeDir(api, path);
+    AsRoot(api);
+    ExpectSuccess(path.Mount(name, "tmpfs", 0, {"size=64m"}));
+    AsAlice(api);
+
     ExpectApiSuccess(api.Create(name));
+    ExpectApiSuccess(api.SetProperty(name, "cwd", path.ToString()));
     ExpectApiSuccess(api.GetProperty(name, "stdout_path", v));
-    ExpectApiSuccess(api.SetProperty(name, "command", "bash -c 'dd if=/dev/zero bs=1M count=100 && sleep 5'"));
-    std::string cwd;
-    ExpectApiSuccess(api.GetProperty(name, "cwd", cwd));
+    ExpectApiSuccess(api.SetProperty(name, "command",
+                "bash -c 'dd if=/dev/zero bs=1M count=" +
+                std::to_string((2 * config().container().max_log_size()) >> 20) +
+                " && echo tail'"));
     ExpectApiSuccess(api.Start(name));
     WaitContainer(api, name);
 
-    TPath stdoutPath(cwd + "/" + v);
+    TPath stdoutPath(path / v);
     ExpectSuccess(stdoutPath.StatFollow(st));
     ExpectLess(st.st_blocks * 512, config().container().max_log_size());
+
+    Say() << "Make sure recent output survived rotation" << std::endl;
+    ExpectApiSuccess(api.GetData(name, "stdout", v));
+    Expect(v.find("tail\n") != std::string::npos);
+
+    ExpectApiSuccess(api.GetData(name, "stdout_offset", offset));
+    ExpectNeq(offset, "0");
+    ExpectApiSuccess(api.GetData(name, "stdout[" + offset + "]", v));
+    Expect(v.find("tail\n") != std::string::npos);
+    ExpectApiFailure(api.GetData(name, "stdout[0]", v), EError::InvalidData);
+
+    ExpectApiSuccess(api.Destroy(name));
+
+    AsRoot(api);
+    ExpectSuccess(path.Umount(0));
+    AsAlice(api);
 }
 
 static void InitErrorCounters(Porto::Connection &api) {
@@ -5417,6 +6013,9 @@ int SelfTest(std::vector<std::string> args) {
         { "hostname_property", TestHostnameProperty },
         { "bind_property", TestBindProperty },
         { "net_property", TestNetProperty },
+        { "devices_property", TestDevicesProperty },
+        { "unified_cgroups", TestUnifiedCgroups },
+        { "thread_limit", TestThreadLimit },
         { "capabilities_property", TestCapabilitiesProperty },
         { "enable_porto_property", TestEnablePortoProperty },
         { "limits", TestLimits },
@@ -5426,6 +6025,10 @@ int SelfTest(std::vector<std::string> args) {
         { "dynamic", TestDynamic },
         { "permissions", TestPermissions },
         { "respawn_property", TestRespawnProperty },
+        { "apply_spec", TestApplySpec },
+        { "checkpoint", TestCheckpoint },
+        { "busy_get", TestBusyGet },
+        { "request_queue", TestRequestQueue },
         { "hierarchy", TestLimitsHierarchy },
         { "vholder", TestVolumeHolder },
         { "volume_impl", TestVolumeImpl },
@@ -5438,13 +6041,14 @@ int SelfTest(std::vector<std::string> args) {
 
         // the following tests will restart porto several times
         { "bad_client", TestBadClient },
+        { "request_limits", TestRequestLimits },
         { "recovery", TestRecovery },
         { "wait_recovery", TestWaitRecovery },
         { "volume_recovery", TestVolumeRecovery },
         { "cgroups", TestCgroups },
         { "version", TestVersion },
         // { "remove_dead", TestRemoveDead }, FIXME
-        // { "log_rotate", TestLogRotate }, FIXME
+        { "log_rotate", TestLogRotate },
         { "stats", TestStats },
     };
 
@@ -8,6 +8,7 @@
 
 #include "config.hpp"
 #include "util/string.hpp"
+#include "util/unix.hpp"
 #include "test.hpp"
 
 extern "C" {
@@ -256,6 +257,146 @@ static void StressKill() {
     }
 }
 
+/*
+ * Crash-looping containers respawn with backoff and host-wide rate limit,
+ * so respawn rate should stay below start_rate + start_burst per second.
+ */
+int RespawnTest(int containers, int seconds) {
+    std::vector<uint64_t> rates;
+    std::string v;
+
+    try {
+        config.Load();
+        Porto::Connection api;
+
+        for (int i = 0; i < containers; i++) {
+            std::string name = "respawntest" + std::to_string(i);
+            ExpectApiSuccess(api.Create(name));
+            ExpectApiSuccess(api.SetProperty(name, "command", "false"));
+            ExpectApiSuccess(api.SetProperty(name, "respawn", "true"));
+            ExpectApiSuccess(api.SetProperty(name, "isolate", "false"));
+        }
+
+        for (int i = 0; i < containers; i++)
+            ExpectApiSuccess(api.Start("respawntest" + std::to_string(i)));
+
+        uint64_t prev, cur;
+        ExpectApiSuccess(api.GetData("/", "porto_stat[respawned]", v));
+        StringToUint64(v, prev);
+
+        for (int t = 0; t < seconds; t++) {
+            usleep(1000000);
+            ExpectApiSuccess(api.GetData("/", "porto_stat[respawned]", v));
+            StringToUint64(v, cur);
+            rates.push_back(cur - prev);
+            std::cout << "Second " << t << ": " << cur - prev << " respawns" << std::endl;
+            prev = cur;
+        }
+
+        ExpectApiSuccess(api.GetData("/", "porto_stat[respawn_throttled]", v));
+        std::cout << "Throttled: " << v << std::endl;
+        ExpectApiSuccess(api.GetData("respawntest0", "respawn_attempts", v));
+        std::cout << "Attempts: " << v << std::endl;
+        ExpectApiSuccess(api.GetData("respawntest0", "respawn_delay", v));
+        std::cout << "Delay: " << v << " ms" << std::endl;
+
+        for (int i = 0; i < containers; i++)
+            ExpectApiSuccess(api.Destroy("respawntest" + std::to_string(i)));
+
+        uint64_t peak = *std::max_element(rates.begin(), rates.end());
+        std::cout << "Peak: " << peak << " respawns/s" << std::endl;
+
+        if (config().container().start_rate())
+            ExpectLessEq(peak, (size_t)config().container().start_rate() +
+                               config().container().start_burst());
+    } catch (std::string e) {
+        std::cerr << "ERROR: " << e << std::endl;
+        abort();
+    }
+
+    std::cout << "Test completed!" << std::endl;
+
+    return 0;
+}
+
+static const std::vector<std::pair<std::string, std::string>> SpecProperties = {
+    { "command", "sleep 1000" },
+    { "isolate", "false" },
+    { "env", "A=1;B=2;C=3" },
+    { "cwd", "/tmp" },
+    { "stdout_path", "/dev/null" },
+    { "stderr_path", "/dev/null" },
+    { "respawn", "false" },
+    { "max_respawns", "-1" },
+    { "aging_time", "3600" },
+    { "private", "spectest" },
+    { "ulimit", "nofile: 1024 1024" },
+    { "stdout_limit", "1048576" },
+    { "stdin_path", "/dev/null" },
+    { "enable_porto", "false" },
+    { "memory_limit", "0" },
+};
+
+static uint64_t SpecPercentile(std::vector<uint64_t> &lat, int pct) {
+    std::sort(lat.begin(), lat.end());
+    return lat[std::min(lat.size() - 1, lat.size() * pct / 100)];
+}
+
+/*
+ * Compares create-to-running latency of Create + SetProperty... + Start
+ * sequence with single ApplySpec request.
+ */
+int SpecTest(int containers) {
+    std::vector<uint64_t> legacy, spec;
+    uint64_t legacyTotal, specTotal;
+
+    try {
+        config.Load();
+        Porto::Connection api;
+
+        legacyTotal = GetCurrentTimeMs();
+        for (int i = 0; i < containers; i++) {
+            std::string name = "spectest" + std::to_string(i);
+            uint64_t start = GetCurrentTimeMs();
+            ExpectApiSuccess(api.Create(name));
+            for (auto &prop: SpecProperties)
+                ExpectApiSuccess(api.SetProperty(name, prop.first, prop.second));
+            ExpectApiSuccess(api.Start(name));
+            legacy.push_back(GetCurrentTimeMs() - start);
+        }
+        legacyTotal = GetCurrentTimeMs() - legacyTotal;
+
+        for (int i = 0; i < containers; i++)
+            ExpectApiSuccess(api.Destroy("spectest" + std::to_string(i)));
+
+        specTotal = GetCurrentTimeMs();
+        for (int i = 0; i < containers; i++) {
+            std::string name = "spectest" + std::to_string(i);
+            uint64_t start = GetCurrentTimeMs();
+            ExpectApiSuccess(api.ApplySpec(name, SpecProperties, {}, true));
+            spec.push_back(GetCurrentTimeMs() - start);
+        }
+        specTotal = GetCurrentTimeMs() - specTotal;
+
+        for (int i = 0; i < containers; i++)
+            ExpectApiSuccess(api.Destroy("spectest" + std::to_string(i)));
+
+        std::cout << "Legacy: " << legacyTotal << " ms total, p50 "
+                  << SpecPercentile(legacy, 50) << " ms, p99 "
+                  << SpecPercentile(legacy, 99) << " ms" << std::endl;
+        std::cout << "Spec:   " << specTotal << " ms total, p50 "
+                  << SpecPercentile(spec, 50) << " ms, p99 "
+                  << SpecPercentile(spec, 99) << " ms" << std::endl;
+    } catch (std::string e) {
+        std::cerr << "ERROR: " << e << std::endl;
+        abort();
+    }
+
+    std::cout << "Test completed!" << std::endl;
+
+    return 0;
+}
+
 int StressTest(int threads, int iter, bool killPorto) {
     int i;
     std::vector<std::thread> thrTasks;
@@ -280,7 +421,9 @@ int StressTest(int threads, int iter, bool killPorto) {
         if (killPorto)
             thrKill.join();
 
-        TestDaemon(api);
+        /* simulated portod has no netlink and own pid files */
+        if (!getenv("PORTO_SOCKET"))
+            TestDaemon(api);
     } catch (std::string e) {
         std::cerr << "ERROR: " << e << std::endl;
         abort();
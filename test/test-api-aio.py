@@ -0,0 +1,25 @@
+import porto
+import asyncio
+
+import test_common
+from test_common import *
+
+DropPrivileges()
+
+# asyncio API, python 3.5+ only
+
+container_name = "test-api-aio.py-a"
+
+async def async_poll():
+    a = porto.AsyncConnection(pool_size=8)
+    names = await a.List()
+    states = await asyncio.gather(*[a.GetData(n, "state") for n in names])
+    assert len(states) == len(names)
+    try:
+        await a.GetData(container_name, "state")
+        assert False
+    except porto.exceptions.ContainerDoesNotExist:
+        pass
+    await a.close()
+
+asyncio.get_event_loop().run_until_complete(async_poll())
@@ -174,3 +174,28 @@ if Catch(c.Find, container_name) != porto.exceptions.ContainerDoesNotExist:
 
 Catch(c.Destroy, container_name)
 c.disconnect()
+
+# connection pool
+
+import threading
+
+p = porto.Connection(pool_size=4)
+p.connect()
+errors = []
+
+def poll():
+    try:
+        for i in range(100):
+            assert "/" in p.List()
+            p.GetData("/", "state")
+    except Exception as e:
+        errors.append(e)
+
+threads = [threading.Thread(target=poll) for i in range(8)]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+assert not errors
+assert len(p.rpc.pool) <= 4
+p.disconnect()
@@ -0,0 +1,95 @@
+import porto
+import os
+import shutil
+import tarfile
+import tempfile
+
+import test_common
+from test_common import *
+
+DropPrivileges()
+
+c = porto.Connection()
+c.connect()
+
+prefix = "test-layer-whiteouts.py-"
+base_name = prefix + "base"
+upper_name = prefix + "upper"
+volume_path = "/tmp/" + prefix + "volume"
+
+# names which tar reports escaped: space, backslash, tab, non-ASCII
+odd_names = ["sp ace", "back\\slash", "tab\tname", "n\xc3\xbcn-ascii"]
+
+def MakeTarball(path, files, dirs=[]):
+    tmp = tempfile.mkdtemp(prefix=prefix)
+    for d in dirs:
+        os.makedirs(os.path.join(tmp, d))
+    for f in files:
+        open(os.path.join(tmp, f), 'w').close()
+    t = tarfile.open(path, 'w')
+    for e in sorted(os.listdir(tmp)):
+        t.add(os.path.join(tmp, e), e)
+    t.close()
+    shutil.rmtree(tmp)
+
+def VolumeFiles(layers):
+    os.mkdir(volume_path)
+    v = c.CreateVolume(volume_path, layers=layers)
+    files = set()
+    for root, dirs, names in os.walk(volume_path):
+        for n in dirs + names:
+            files.add(os.path.relpath(os.path.join(root, n), volume_path))
+    v.Unlink()
+    os.rmdir(volume_path)
+    return files
+
+# CLEANUP
+
+for l in [base_name, upper_name]:
+    if not Catch(c.FindLayer, l):
+        c.RemoveLayer(l)
+
+if not Catch(c.FindVolume, volume_path):
+    c.DestroyVolume(volume_path)
+
+if os.access(volume_path, os.F_OK):
+    os.rmdir(volume_path)
+
+base_tar = tempfile.mktemp(prefix=prefix, suffix=".tar")
+upper_tar = tempfile.mktemp(prefix=prefix, suffix=".tar")
+
+# whiteout "e/.wh.f" comes after its parent is removed by ".wh.e"
+MakeTarball(base_tar, ["a", "keep", "d/x", "e/f"] + odd_names, ["d", "e"])
+MakeTarball(upper_tar,
+            [".wh.a", "d/.wh..wh..opq", "d/y", "new file\\with \xc3\xbc",
+             ".wh.e", "e/.wh.f"] +
+            [".wh." + n for n in odd_names], ["d", "e"])
+
+# separate layers: whiteouts hide entries of lower layer
+
+c.ImportLayer(base_name, base_tar)
+c.ImportLayer(upper_name, upper_tar)
+
+files = VolumeFiles([base_name])
+assert files == set(["a", "keep", "d", "d/x", "e", "e/f"] + odd_names)
+
+files = VolumeFiles([upper_name, base_name])
+assert files == set(["keep", "d", "d/y", "new file\\with \xc3\xbc"])
+
+c.RemoveLayer(upper_name)
+
+# merged layer: whiteouts remove entries
+
+c.rpc.ImportLayer(base_name, upper_tar, merge=True)
+
+files = VolumeFiles([base_name])
+assert not [f for f in files if ".wh." in f]
+for n in ["a", "e", "e/f"] + odd_names:
+    assert n not in files
+for n in ["keep", "d/y", "new file\\with \xc3\xbc"]:
+    assert n in files
+
+c.RemoveLayer(base_name)
+os.unlink(base_tar)
+os.unlink(upper_tar)
+c.disconnect()
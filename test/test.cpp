@@ -671,6 +671,24 @@ void InitKernelFeatures() {
     kernel_features[static_cast<int>(KernelFeature::IPVLAN)] = HaveIpVlan();
     kernel_features[static_cast<int>(KernelFeature::MAX_RSS)] = HaveMaxRss();
     kernel_features[static_cast<int>(KernelFeature::CFQ)] = IsCfqActive();
+    kernel_features[static_cast<int>(KernelFeature::CGROUP2)] =
+        TPath("/sys/fs/cgroup/cgroup.controllers").Exists();
+
+    std::string cgroups;
+    kernel_features[static_cast<int>(KernelFeature::PIDS)] =
+        !TPath("/proc/cgroups").ReadAll(cgroups) &&
+        cgroups.find("\npids\t") != std::string::npos;
+    kernel_features[static_cast<int>(KernelFeature::MEMORY_HIGH)] =
+        HaveCgKnob("memory", "memory.high_limit_in_bytes") ||
+        TPath("/sys/fs/cgroup/porto/memory.high").Exists();
+    kernel_features[static_cast<int>(KernelFeature::CPU_WAIT)] =
+        HaveCgKnob("cpuacct", "cpuacct.wait") ||
+        TPath("/sys/fs/cgroup/porto/cpu.pressure").Exists();
+    kernel_features[static_cast<int>(KernelFeature::MEMORY_STALL)] =
+        TPath("/sys/fs/cgroup/porto/memory.pressure").Exists();
+    kernel_features[static_cast<int>(KernelFeature::MEMORY_EVENTS)] =
+        HaveCgKnob("memory", "memory.events") ||
+        TPath("/sys/fs/cgroup/porto/memory.events").Exists();
 
     std::cout << "Kernel features:" << std::endl;
     std::cout << std::left << std::setw(30) << "  SMART" <<
@@ -693,6 +711,18 @@ void InitKernelFeatures() {
         (KernelSupports(KernelFeature::MAX_RSS) ? "yes" : "no") << std::endl;
     std::cout << std::left << std::setw(30) << "  CFQ" <<
         (KernelSupports(KernelFeature::CFQ) ? "yes" : "no") << std::endl;
+    std::cout << std::left << std::setw(30) << "  CGROUP2" <<
+        (KernelSupports(KernelFeature::CGROUP2) ? "yes" : "no") << std::endl;
+    std::cout << std::left << std::setw(30) << "  PIDS" <<
+        (KernelSupports(KernelFeature::PIDS) ? "yes" : "no") << std::endl;
+    std::cout << std::left << std::setw(30) << "  MEMORY_HIGH" <<
+        (KernelSupports(KernelFeature::MEMORY_HIGH) ? "yes" : "no") << std::endl;
+    std::cout << std::left << std::setw(30) << "  CPU_WAIT" <<
+        (KernelSupports(KernelFeature::CPU_WAIT) ? "yes" : "no") << std::endl;
+    std::cout << std::left << std::setw(30) << "  MEMORY_STALL" <<
+        (KernelSupports(KernelFeature::MEMORY_STALL) ? "yes" : "no") << std::endl;
+    std::cout << std::left << std::setw(30) << "  MEMORY_EVENTS" <<
+        (KernelSupports(KernelFeature::MEMORY_EVENTS) ? "yes" : "no") << std::endl;
 }
 
 template<typename T>
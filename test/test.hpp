@@ -72,6 +72,8 @@ namespace test {
 
     int SelfTest(std::vector<std::string> args);
     int StressTest(int threads, int iter, bool killPorto);
+    int RespawnTest(int containers, int seconds);
+    int SpecTest(int containers);
     int FuzzyTest(int threads, int iter);
 
     enum class KernelFeature {
@@ -85,6 +87,12 @@ namespace test {
         IPVLAN,
         MAX_RSS,
         CFQ,
+        CGROUP2,
+        PIDS,
+        MEMORY_HIGH,
+        CPU_WAIT,
+        MEMORY_STALL,
+        MEMORY_EVENTS,
         LAST
     };
 